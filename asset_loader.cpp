@@ -0,0 +1,246 @@
+#include "asset_loader.h"
+#include "profiler.h"
+#include "baked_texture.h"
+#include "asset_pack.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+namespace
+{
+  double millisecondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  bool readFile(const std::string& path, std::vector<unsigned char>& bytes)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+      return false;
+
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !bytes.empty();
+  }
+}
+
+bool TextureRequest::isReady() const
+{
+  return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+AssetLoader::AssetLoader(unsigned int workerCount)
+  : stopping(false), startTime(std::chrono::steady_clock::now())
+{
+  if (workerCount == 0)
+  {
+    // Startup only has a handful of assets; a few workers are enough
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    workerCount = std::clamp(hardwareThreads, 1u, 4u);
+  }
+
+  // Workers pick baked variants by format support, which needs the GL context
+  BakedTexture::querySupport();
+
+  for (unsigned int i = 0; i < workerCount; i++)
+    workers.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+AssetLoader::~AssetLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    stopping = true;
+  }
+  jobSignal.notify_all();
+
+  for (auto& worker : workers)
+    worker.join();
+}
+
+void AssetLoader::workerLoop()
+{
+  Profiler::setThreadName("Asset worker");
+
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(jobMutex);
+      jobSignal.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (jobs.empty())
+        return; // Stopping and nothing left to do
+      job = std::move(jobs.front());
+      jobs.pop();
+    }
+    job();
+  }
+}
+
+TextureRequest AssetLoader::requestTexture(const std::string& name)
+{
+  std::vector<std::string> candidatePaths = { "assets/" + name, name };
+
+  // Already resident: no I/O or decode needed
+  unsigned int cached = TextureLoader::acquireCachedTexture(name);
+  if (cached != 0)
+  {
+    TextureLoader::releaseTexture(cached); // finishTexture takes its own reference
+    TextureRequest request;
+    request.name = name;
+    request.candidatePaths = std::move(candidatePaths);
+    request.cached = true;
+    return request;
+  }
+
+  auto task = std::make_shared<std::packaged_task<DecodedTexture()>>([this, name, candidatePaths]() {
+    PROFILE_ZONE("Decode texture");
+    DecodedTexture decoded;
+
+    bool baked;
+    AssetView packed = TextureLoader::findPackedTexture(name, baked);
+    if (packed.isValid() && baked)
+    {
+      // Baked entries are uploaded straight out of the pack mapping
+      decoded.bakedData = packed.data;
+      decoded.bakedSize = packed.size;
+      decoded.contentHash = packed.contentHash;
+      return decoded;
+    }
+    if (packed.isValid())
+    {
+      auto decodeStart = std::chrono::steady_clock::now();
+      if (TextureLoader::decodeImage(packed.data, packed.size, decoded.image))
+        decoded.image.path = name;
+      decoded.contentHash = packed.contentHash;
+      decoded.decodeMs += millisecondsSince(decodeStart);
+      addStageTime("Decode (workers)", decoded.decodeMs);
+      return decoded;
+    }
+
+    for (const auto& path : candidatePaths)
+    {
+      // A baked .ltex only needs mapping here; the GL thread uploads from the mapping
+      auto mapStart = std::chrono::steady_clock::now();
+      for (const auto& bakedPath : BakedTexture::candidatePathsFor(path))
+      {
+        auto mapping = std::make_shared<MappedFile>();
+        if (mapping->open(bakedPath.c_str()) && BakedTexture::validate(mapping->data(), mapping->size()))
+        {
+          decoded.bakedFile = mapping;
+          decoded.bakedData = mapping->data();
+          decoded.bakedSize = mapping->size();
+          decoded.contentHash = AssetPack::hash(mapping->data(), mapping->size());
+          break;
+        }
+      }
+      decoded.readMs += millisecondsSince(mapStart);
+      if (decoded.bakedData)
+        break;
+
+      auto readStart = std::chrono::steady_clock::now();
+      std::vector<unsigned char> bytes;
+      bool found = readFile(path, bytes);
+      decoded.readMs += millisecondsSince(readStart);
+      if (!found)
+        continue; // Try the next alternative path
+
+      auto decodeStart = std::chrono::steady_clock::now();
+      bool decodedOk = TextureLoader::decodeImage(bytes.data(), bytes.size(), decoded.image);
+      decoded.decodeMs += millisecondsSince(decodeStart);
+      if (decodedOk)
+      {
+        decoded.image.path = path;
+        decoded.contentHash = AssetPack::hash(bytes.data(), bytes.size());
+        break;
+      }
+    }
+
+    addStageTime("File I/O (workers)", decoded.readMs);
+    addStageTime("Decode (workers)", decoded.decodeMs);
+    return decoded;
+  });
+
+  TextureRequest request;
+  request.name = name;
+  request.candidatePaths = std::move(candidatePaths);
+  request.result = task->get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    jobs.push([task]() { (*task)(); });
+  }
+  jobSignal.notify_one();
+
+  return request;
+}
+
+unsigned int AssetLoader::finishTexture(TextureRequest& request)
+{
+  if (request.cached)
+    return TextureLoader::acquireCachedTexture(request.name);
+  if (!request.result.valid())
+    return 0;
+
+  DecodedTexture decoded;
+  {
+    StageTimer timer(*this, "Wait for decode");
+    decoded = request.result.get();
+  }
+
+  unsigned int textureID = 0;
+  if (decoded.bakedData)
+  {
+    StageTimer timer(*this, "GL upload");
+    textureID = BakedTexture::upload(decoded.bakedData, decoded.bakedSize);
+  }
+  else if (decoded.image.isValid())
+  {
+    StageTimer timer(*this, "GL upload");
+    textureID = TextureLoader::uploadTexture(decoded.image, true);
+  }
+
+  if (textureID == 0)
+  {
+    std::cout << "Failed to load texture: " << request.name << std::endl;
+    return 0;
+  }
+
+  // Identical content under another name collapses onto the resident texture
+  bool premultiplied = decoded.bakedData && BakedTexture::isPremultiplied(decoded.bakedData, decoded.bakedSize);
+  return TextureLoader::registerTexture(request.name, textureID, decoded.contentHash, premultiplied);
+}
+
+void AssetLoader::addStageTime(const std::string& stage, double ms)
+{
+  std::lock_guard<std::mutex> lock(statsMutex);
+  for (auto& entry : stageTimes)
+  {
+    if (entry.first == stage)
+    {
+      entry.second += ms;
+      return;
+    }
+  }
+  stageTimes.emplace_back(stage, ms);
+}
+
+void AssetLoader::printStartupReport()
+{
+  std::lock_guard<std::mutex> lock(statsMutex);
+  std::cout << "Startup timing:" << std::endl;
+  for (const auto& entry : stageTimes)
+    std::cout << "  " << entry.first << ": " << entry.second << " ms" << std::endl;
+  std::cout << "  Total (wall): " << millisecondsSince(startTime) << " ms" << std::endl;
+}
+
+StageTimer::StageTimer(AssetLoader& loader, const char* stage)
+  : loader(loader), stage(stage), start(std::chrono::steady_clock::now())
+{
+}
+
+StageTimer::~StageTimer()
+{
+  loader.addStageTime(stage, millisecondsSince(start));
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "texture_loader.h"
+#include "mapped_file.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Result of a worker-side texture decode
+struct DecodedTexture {
+  ImageData image;                          // Decoded pixels (unbaked source image)
+  const unsigned char* bakedData = nullptr; // .ltex contents, used instead of image when set
+  size_t bakedSize = 0;
+  std::shared_ptr<MappedFile> bakedFile;    // Keeps a loose .ltex mapped (pack data stays mapped anyway)
+  uint64_t contentHash = 0;                 // Hash of the source bytes, for registry de-duplication
+  double readMs = 0.0;     // Time spent reading the file
+  double decodeMs = 0.0;   // Time spent decoding it
+};
+
+// Handle for a texture being decoded in the background
+struct TextureRequest {
+  std::string name;                          // Asset name, e.g. "llama.png"
+  std::vector<std::string> candidatePaths;   // Loose files tried in order when the pack lacks it
+  std::future<DecodedTexture> result;        // Not valid when the texture was already registered
+  bool cached = false;
+
+  bool isReady() const;
+};
+
+// Loads assets during startup so file I/O, image decoding and GL work overlap.
+// Files are read and decoded on a worker pool; uploads happen on the GL thread
+// through pixel buffer objects. Per-stage timings are collected for a startup report.
+// Assets resolve by name: the mounted AssetPack first, then assets/<name>, then <name>.
+class AssetLoader
+{
+public:
+  // workerCount 0 picks a count based on the hardware
+  explicit AssetLoader(unsigned int workerCount = 0);
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  // Queue a texture decode by asset name (skipped if the registry already holds it)
+  TextureRequest requestTexture(const std::string& name);
+
+  // Wait for a decode to finish, upload it and register it with TextureLoader
+  // (GL thread only). Returns an acquired texture, or 0 on failure.
+  unsigned int finishTexture(TextureRequest& request);
+
+  // Record time spent in a stage done outside the loader (e.g. shader compilation)
+  void addStageTime(const std::string& stage, double ms);
+
+  // Print per-stage timings and total wall time since construction
+  void printStartupReport();
+
+private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> jobs;
+  std::mutex jobMutex;
+  std::condition_variable jobSignal;
+  bool stopping;
+
+  std::mutex statsMutex;
+  std::vector<std::pair<std::string, double>> stageTimes;   // In first-seen order
+  std::chrono::steady_clock::time_point startTime;
+
+  void workerLoop();
+};
+
+// Measures a block and reports it to an AssetLoader stage on destruction
+class StageTimer
+{
+public:
+  StageTimer(AssetLoader& loader, const char* stage);
+  ~StageTimer();
+
+private:
+  AssetLoader& loader;
+  const char* stage;
+  std::chrono::steady_clock::time_point start;
+};
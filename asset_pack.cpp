@@ -0,0 +1,178 @@
+#include "asset_pack.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+  std::unique_ptr<AssetPack> mountedPack;
+
+  uint64_t alignUp(uint64_t value)
+  {
+    return (value + 15) & ~(uint64_t)15;
+  }
+}
+
+uint64_t AssetPack::hash(const void* data, size_t size)
+{
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t value = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++)
+  {
+    value ^= bytes[i];
+    value *= 1099511628211ull;
+  }
+  return value;
+}
+
+bool AssetPack::open(const char* path)
+{
+  if (!file.open(path))
+    return false;
+
+  const unsigned char* data = file.data();
+  size_t size = file.size();
+
+  AssetPackHeader header;
+  if (size < sizeof(header))
+    return false;
+  memcpy(&header, data, sizeof(header));
+
+  if (memcmp(header.magic, "LPAK", 4) != 0 || header.version != VERSION)
+  {
+    std::cout << "Not a valid asset pack: " << path << std::endl;
+    file.close();
+    return false;
+  }
+
+  // Everything the index points at must lie inside the file
+  uint64_t indexEnd = header.indexOffset + (uint64_t)header.entryCount * sizeof(AssetPackEntry);
+  if (indexEnd > size || header.namesOffset > size)
+  {
+    std::cout << "Truncated asset pack: " << path << std::endl;
+    file.close();
+    return false;
+  }
+
+  const AssetPackEntry* table = (const AssetPackEntry*)(data + header.indexOffset);
+  for (uint32_t i = 0; i < header.entryCount; i++)
+  {
+    bool nameOk = header.namesOffset + table[i].nameOffset + table[i].nameLength <= size;
+    bool dataOk = table[i].offset <= size && table[i].size <= size - table[i].offset;
+    if (!nameOk || !dataOk)
+    {
+      std::cout << "Corrupt asset pack index: " << path << std::endl;
+      file.close();
+      return false;
+    }
+  }
+
+  entries = table;
+  entryCount = header.entryCount;
+  names = (const char*)data + header.namesOffset;
+  return true;
+}
+
+AssetView AssetPack::find(const std::string& name) const
+{
+  AssetView view;
+  if (!entries)
+    return view;
+
+  uint64_t nameHash = hash(name.data(), name.size());
+  const AssetPackEntry* end = entries + entryCount;
+  const AssetPackEntry* it = std::lower_bound(entries, end, nameHash,
+    [](const AssetPackEntry& entry, uint64_t value) { return entry.nameHash < value; });
+
+  // Compare names too, in case two names share a hash
+  for (; it != end && it->nameHash == nameHash; ++it)
+  {
+    if (it->nameLength == name.size() && memcmp(names + it->nameOffset, name.data(), name.size()) == 0)
+    {
+      view.data = file.data() + it->offset;
+      view.size = (size_t)it->size;
+      view.contentHash = it->contentHash;
+      return view;
+    }
+  }
+  return view;
+}
+
+std::string AssetPack::getEntryName(size_t index) const
+{
+  if (index >= entryCount)
+    return std::string();
+  return std::string(names + entries[index].nameOffset, entries[index].nameLength);
+}
+
+bool AssetPack::mount(const char* path)
+{
+  auto pack = std::make_unique<AssetPack>();
+  if (!pack->open(path))
+    return false;
+
+  std::cout << "Mounted asset pack " << path << " (" << pack->getEntryCount() << " assets)" << std::endl;
+  mountedPack = std::move(pack);
+  return true;
+}
+
+const AssetPack* AssetPack::getMounted()
+{
+  return mountedPack.get();
+}
+
+std::string AssetPack::resolveText(const std::string& name, const char* builtin)
+{
+  if (mountedPack)
+  {
+    AssetView view = mountedPack->find(name);
+    if (view.isValid())
+      return std::string((const char*)view.data, view.size);
+  }
+  return builtin;
+}
+
+void AssetPack::build(const std::vector<std::pair<std::string, std::vector<unsigned char>>>& assets,
+  std::vector<unsigned char>& out)
+{
+  std::vector<AssetPackEntry> table(assets.size());
+  std::string nameBlob;
+  for (size_t i = 0; i < assets.size(); i++)
+  {
+    const auto& name = assets[i].first;
+    const auto& bytes = assets[i].second;
+    table[i].nameHash = hash(name.data(), name.size());
+    table[i].contentHash = hash(bytes.data(), bytes.size());
+    table[i].size = bytes.size();
+    table[i].nameOffset = (uint32_t)nameBlob.size();
+    table[i].nameLength = (uint32_t)name.size();
+    nameBlob += name;
+  }
+
+  AssetPackHeader header = {};
+  memcpy(header.magic, "LPAK", 4);
+  header.version = VERSION;
+  header.entryCount = (uint32_t)assets.size();
+  header.indexOffset = sizeof(AssetPackHeader);
+  header.namesOffset = header.indexOffset + table.size() * sizeof(AssetPackEntry);
+
+  uint64_t offset = alignUp(header.namesOffset + nameBlob.size());
+  for (auto& entry : table)
+  {
+    entry.offset = offset;
+    offset = alignUp(offset + entry.size);
+  }
+
+  out.assign((size_t)offset, 0);
+  for (size_t i = 0; i < assets.size(); i++)
+    memcpy(out.data() + table[i].offset, assets[i].second.data(), assets[i].second.size());
+
+  // Sort the index by name hash; data offsets travel with their entries
+  std::sort(table.begin(), table.end(),
+    [](const AssetPackEntry& a, const AssetPackEntry& b) { return a.nameHash < b.nameHash; });
+
+  memcpy(out.data(), &header, sizeof(header));
+  memcpy(out.data() + header.indexOffset, table.data(), table.size() * sizeof(AssetPackEntry));
+  memcpy(out.data() + header.namesOffset, nameBlob.data(), nameBlob.size());
+}
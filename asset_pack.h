@@ -0,0 +1,81 @@
+#pragma once
+
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// .lpak asset pack, little-endian:
+//   AssetPackHeader
+//   AssetPackEntry[entryCount]   sorted by nameHash for binary search
+//   Name strings (not null-terminated)
+//   Asset data (16-byte aligned)
+// The pack is mapped once and every asset is a view into the mapping.
+struct AssetPackHeader {
+  char magic[4];          // "LPAK"
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t reserved;
+  uint64_t indexOffset;   // First AssetPackEntry
+  uint64_t namesOffset;   // Start of the name strings
+};
+
+struct AssetPackEntry {
+  uint64_t nameHash;      // FNV-1a of the asset name
+  uint64_t contentHash;   // FNV-1a of the asset bytes
+  uint64_t offset;        // From the start of the file
+  uint64_t size;          // In bytes
+  uint32_t nameOffset;    // From namesOffset
+  uint32_t nameLength;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32, "AssetPackHeader layout is part of the file format");
+static_assert(sizeof(AssetPackEntry) == 40, "AssetPackEntry layout is part of the file format");
+
+// Read-only view of one asset inside a pack
+struct AssetView {
+  const unsigned char* data = nullptr;
+  size_t size = 0;
+  uint64_t contentHash = 0;
+
+  bool isValid() const { return data != nullptr; }
+};
+
+// A mapped asset pack. Assets are looked up by name relative to the asset root,
+// e.g. "llama.png" or "shaders/sprite.vert".
+class AssetPack
+{
+public:
+  static const uint32_t VERSION = 1;
+
+  // Map a pack file and check its index
+  bool open(const char* path);
+
+  // Find an asset by name; returns an invalid view if it is not in the pack
+  AssetView find(const std::string& name) const;
+
+  size_t getEntryCount() const { return entryCount; }
+
+  // Name of the entry at index (in index order)
+  std::string getEntryName(size_t index) const;
+
+  // Process-wide pack that texture and shader lookups resolve against
+  static bool mount(const char* path);
+  static const AssetPack* getMounted();
+
+  // Shader/text lookup: pack entry if present, otherwise the built-in source
+  static std::string resolveText(const std::string& name, const char* builtin);
+
+  // 64-bit FNV-1a, used for names and contents
+  static uint64_t hash(const void* data, size_t size);
+
+  // Build a pack from (name, bytes) pairs
+  static void build(const std::vector<std::pair<std::string, std::vector<unsigned char>>>& assets,
+    std::vector<unsigned char>& out);
+
+private:
+  MappedFile file;
+  const AssetPackEntry* entries = nullptr;
+  size_t entryCount = 0;
+  const char* names = nullptr;
+};
@@ -0,0 +1,316 @@
+// asset_tool.cpp : Offline asset processing for learn_open_gl.
+//
+// Usage:
+//   asset_tool bake <input.png> [output.ltex] [--premultiply]
+//   asset_tool encode <input.png> [--formats bc7,bc3,etc2] [--pixel-art] [--max-error N] [--premultiply]
+//   asset_tool pack <output.lpak> <asset_dir>
+//   asset_tool list <pack.lpak>
+//
+#include "texture_loader.h"
+#include "baked_texture.h"
+#include "asset_pack.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+  void printUsage()
+  {
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  asset_tool bake <input.png> [output.ltex] [--premultiply]" << std::endl;
+    std::cout << "  asset_tool encode <input.png> [--formats bc7,bc3,etc2] [--pixel-art] [--max-error N] [--premultiply]"
+      << std::endl;
+    std::cout << "  asset_tool pack <output.lpak> <asset_dir>" << std::endl;
+    std::cout << "  asset_tool list <pack.lpak>" << std::endl;
+  }
+
+  bool readFile(const std::string& path, std::vector<unsigned char>& bytes)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+      return false;
+
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !bytes.empty();
+  }
+
+  bool writeFile(const std::string& path, const std::vector<unsigned char>& bytes)
+  {
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+      return false;
+
+    file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    return (bool)file;
+  }
+
+  bool loadImage(const std::string& path, ImageData& image)
+  {
+    std::vector<unsigned char> bytes;
+    if (!readFile(path, bytes))
+    {
+      std::cout << "Failed to read: " << path << std::endl;
+      return false;
+    }
+    if (!TextureLoader::decodeImage(bytes.data(), bytes.size(), image))
+    {
+      std::cout << "Failed to decode: " << path << std::endl;
+      return false;
+    }
+    image.path = path;
+    return true;
+  }
+
+  int bakeCommand(const std::vector<std::string>& args)
+  {
+    std::string input, output;
+    bool premultiply = false;
+    for (const auto& arg : args)
+    {
+      if (arg == "--premultiply")
+        premultiply = true;
+      else if (input.empty())
+        input = arg;
+      else if (output.empty())
+        output = arg;
+    }
+
+    if (input.empty())
+    {
+      printUsage();
+      return 1;
+    }
+    if (output.empty())
+      output = BakedTexture::bakedPathFor(input);
+
+    ImageData image;
+    if (!loadImage(input, image))
+      return 1;
+
+    std::vector<unsigned char> baked;
+    if (!BakedTexture::bake(image, premultiply, baked))
+    {
+      std::cout << "Failed to bake: " << input << std::endl;
+      return 1;
+    }
+    if (!writeFile(output, baked))
+    {
+      std::cout << "Failed to write: " << output << std::endl;
+      return 1;
+    }
+
+    std::cout << "Baked " << input << " (" << image.width << "x" << image.height << ", " << image.channels
+      << " channels" << (premultiply ? ", premultiplied" : "") << ") -> " << output
+      << " (" << baked.size() << " bytes)" << std::endl;
+    return 0;
+  }
+
+  bool parseFormats(const std::string& list, std::vector<BakedTextureFormat>& formats)
+  {
+    const BakedTextureFormat known[] = { BAKED_FORMAT_BC7, BAKED_FORMAT_BC3, BAKED_FORMAT_ETC2 };
+    size_t start = 0;
+    while (start <= list.size())
+    {
+      size_t comma = list.find(',', start);
+      std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+      auto match = std::find_if(std::begin(known), std::end(known),
+        [&](BakedTextureFormat format) { return name == BakedTexture::formatName(format); });
+      if (match == std::end(known))
+      {
+        std::cout << "Unknown format: " << name << std::endl;
+        return false;
+      }
+      formats.push_back(*match);
+      if (comma == std::string::npos)
+        break;
+      start = comma + 1;
+    }
+    return true;
+  }
+
+  // Writes every compressed variant plus the raw .ltex the runtime falls back to
+  int encodeCommand(const std::vector<std::string>& args)
+  {
+    std::string input;
+    std::vector<BakedTextureFormat> formats;
+    bool premultiply = false;
+    bool pixelArt = false;
+    int maxAllowedError = 8;
+    for (size_t i = 0; i < args.size(); i++)
+    {
+      if (args[i] == "--premultiply")
+        premultiply = true;
+      else if (args[i] == "--pixel-art")
+        pixelArt = true;
+      else if (args[i] == "--formats" && i + 1 < args.size())
+      {
+        if (!parseFormats(args[++i], formats))
+          return 1;
+      }
+      else if (args[i] == "--max-error" && i + 1 < args.size())
+        maxAllowedError = std::stoi(args[++i]);
+      else if (input.empty())
+        input = args[i];
+    }
+
+    if (input.empty())
+    {
+      printUsage();
+      return 1;
+    }
+    if (formats.empty())
+      formats = { BAKED_FORMAT_BC7, BAKED_FORMAT_BC3, BAKED_FORMAT_ETC2 };
+
+    ImageData image;
+    if (!loadImage(input, image))
+      return 1;
+
+    std::vector<unsigned char> raw;
+    std::string rawPath = BakedTexture::bakedPathFor(input);
+    if (!BakedTexture::bake(image, premultiply, raw) || !writeFile(rawPath, raw))
+    {
+      std::cout << "Failed to write: " << rawPath << std::endl;
+      return 1;
+    }
+    std::cout << "  raw  -> " << rawPath << " (" << raw.size() << " bytes)" << std::endl;
+
+    for (BakedTextureFormat format : formats)
+    {
+      std::string output = BakedTexture::bakedPathFor(input, format);
+      std::vector<unsigned char> encoded;
+      int maxError = 0;
+      if (!BakedTexture::bake(image, premultiply, encoded, format, &maxError))
+      {
+        std::cout << "Failed to encode " << BakedTexture::formatName(format) << ": " << input << std::endl;
+        return 1;
+      }
+
+      // Pixel art can't hide block artifacts; leave the variant out so the loader uses the raw file
+      if (pixelArt && maxError > maxAllowedError)
+      {
+        std::filesystem::remove(output);
+        std::cout << "  " << BakedTexture::formatName(format) << " rejected (max error " << maxError << " > "
+          << maxAllowedError << ")" << std::endl;
+        continue;
+      }
+
+      if (!writeFile(output, encoded))
+      {
+        std::cout << "Failed to write: " << output << std::endl;
+        return 1;
+      }
+      std::cout << "  " << BakedTexture::formatName(format) << "  -> " << output << " (" << encoded.size()
+        << " bytes, max error " << maxError << ")" << std::endl;
+    }
+    return 0;
+  }
+
+  int packCommand(const std::vector<std::string>& args)
+  {
+    if (args.size() < 2)
+    {
+      printUsage();
+      return 1;
+    }
+
+    namespace fs = std::filesystem;
+    fs::path output = args[0];
+    fs::path root = args[1];
+    if (!fs::is_directory(root))
+    {
+      std::cout << "Not a directory: " << root.string() << std::endl;
+      return 1;
+    }
+
+    // Every regular file under the root, named by its relative path with '/' separators
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> assets;
+    std::error_code error;
+    for (const auto& item : fs::recursive_directory_iterator(root))
+    {
+      if (!item.is_regular_file() || fs::equivalent(item.path(), output, error))
+        continue;
+
+      std::string name = fs::relative(item.path(), root).generic_string();
+      std::vector<unsigned char> bytes;
+      if (!readFile(item.path().string(), bytes))
+      {
+        std::cout << "Skipping unreadable file: " << item.path().string() << std::endl;
+        continue;
+      }
+      assets.emplace_back(name, std::move(bytes));
+    }
+
+    // Stable output regardless of directory iteration order
+    std::sort(assets.begin(), assets.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<unsigned char> pack;
+    AssetPack::build(assets, pack);
+    if (!writeFile(output.string(), pack))
+    {
+      std::cout << "Failed to write: " << output.string() << std::endl;
+      return 1;
+    }
+
+    for (const auto& asset : assets)
+      std::cout << "  " << asset.first << " (" << asset.second.size() << " bytes)" << std::endl;
+    std::cout << "Packed " << assets.size() << " assets -> " << output.string()
+      << " (" << pack.size() << " bytes)" << std::endl;
+    return 0;
+  }
+
+  int listCommand(const std::vector<std::string>& args)
+  {
+    if (args.empty())
+    {
+      printUsage();
+      return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(args[0].c_str()))
+    {
+      std::cout << "Failed to open pack: " << args[0] << std::endl;
+      return 1;
+    }
+
+    for (size_t i = 0; i < pack.getEntryCount(); i++)
+    {
+      std::string name = pack.getEntryName(i);
+      AssetView view = pack.find(name);
+      bool intact = AssetPack::hash(view.data, view.size) == view.contentHash;
+      std::cout << "  " << name << " (" << view.size << " bytes)" << (intact ? "" : " HASH MISMATCH") << std::endl;
+    }
+    return 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    printUsage();
+    return 1;
+  }
+
+  std::string command = argv[1];
+  std::vector<std::string> args(argv + 2, argv + argc);
+
+  if (command == "bake")
+    return bakeCommand(args);
+  if (command == "encode")
+    return encodeCommand(args);
+  if (command == "pack")
+    return packCommand(args);
+  if (command == "list")
+    return listCommand(args);
+
+  printUsage();
+  return 1;
+}
@@ -0,0 +1,350 @@
+#include "baked_texture.h"
+#include "texture_loader.h"
+#include "mapped_file.h"
+#include "texture_codec.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+// Not part of core GL, so glad's core header does not define it
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace
+{
+  const uint64_t LEVEL_ALIGNMENT = 16;
+
+  uint64_t alignUp(uint64_t value)
+  {
+    return (value + LEVEL_ALIGNMENT - 1) & ~(LEVEL_ALIGNMENT - 1);
+  }
+
+  GLenum formatForChannels(uint32_t channels)
+  {
+    if (channels == 1)
+      return GL_RED;
+    if (channels == 3)
+      return GL_RGB;
+    return GL_RGBA;
+  }
+
+  GLenum compressedInternalFormat(uint32_t format)
+  {
+    if (format == BAKED_FORMAT_BC3)
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    if (format == BAKED_FORMAT_BC7)
+      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    return GL_COMPRESSED_RGBA8_ETC2_EAC;
+  }
+
+  bool isFormatSupported(uint32_t format)
+  {
+    const CompressedTextureSupport& support = BakedTexture::querySupport();
+    switch (format)
+    {
+    case BAKED_FORMAT_RAW: return true;
+    case BAKED_FORMAT_BC3: return support.bc3;
+    case BAKED_FORMAT_BC7: return support.bc7;
+    case BAKED_FORMAT_ETC2: return support.etc2;
+    default: return false;
+    }
+  }
+
+  uint64_t levelSize(uint32_t format, uint32_t width, uint32_t height, uint32_t channels)
+  {
+    if (format == BAKED_FORMAT_RAW)
+      return (uint64_t)width * height * channels;
+    return TextureCodec::encodedSize((int)width, (int)height);
+  }
+
+  CompressedTextureSupport detectSupport()
+  {
+    CompressedTextureSupport support;
+    if (!glGetIntegerv || !glGetStringi)
+      return support; // No GL loaded (offline tools)
+
+    GLint major = 0, minor = 0, extensionCount = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    int version = major * 10 + minor;
+
+    support.bc7 = version >= 42;
+    support.etc2 = version >= 43;
+    for (GLint i = 0; i < extensionCount; i++)
+    {
+      const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+      if (!name)
+        continue;
+      if (strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+        support.bc3 = true;
+      else if (strcmp(name, "GL_ARB_texture_compression_bptc") == 0)
+        support.bc7 = true;
+      else if (strcmp(name, "GL_ARB_ES3_compatibility") == 0)
+        support.etc2 = true;
+    }
+    return support;
+  }
+
+  // 2x2 box filter; odd edges reuse the last row/column
+  std::vector<unsigned char> downsample(const std::vector<unsigned char>& src, int width, int height, int channels,
+    int& outWidth, int& outHeight)
+  {
+    outWidth = std::max(1, width / 2);
+    outHeight = std::max(1, height / 2);
+    std::vector<unsigned char> dst((size_t)outWidth * outHeight * channels);
+
+    for (int y = 0; y < outHeight; y++)
+    {
+      int y0 = std::min(y * 2, height - 1);
+      int y1 = std::min(y * 2 + 1, height - 1);
+      for (int x = 0; x < outWidth; x++)
+      {
+        int x0 = std::min(x * 2, width - 1);
+        int x1 = std::min(x * 2 + 1, width - 1);
+        for (int c = 0; c < channels; c++)
+        {
+          int sum = src[((size_t)y0 * width + x0) * channels + c] + src[((size_t)y0 * width + x1) * channels + c] +
+            src[((size_t)y1 * width + x0) * channels + c] + src[((size_t)y1 * width + x1) * channels + c];
+          dst[((size_t)y * outWidth + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+        }
+      }
+    }
+    return dst;
+  }
+}
+
+bool BakedTexture::bake(const ImageData& image, bool premultiplyAlpha, std::vector<unsigned char>& out,
+  BakedTextureFormat format, int* maxError)
+{
+  if (!image.isValid() || (image.channels != 1 && image.channels != 3 && image.channels != 4))
+    return false;
+
+  std::vector<unsigned char> level = image.pixels;
+  int channels = image.channels;
+
+  // Block encoders work on RGBA
+  if (format != BAKED_FORMAT_RAW && channels != 4)
+  {
+    std::vector<unsigned char> rgba((size_t)image.width * image.height * 4);
+    for (size_t i = 0; i < (size_t)image.width * image.height; i++)
+    {
+      for (int c = 0; c < 3; c++)
+        rgba[i * 4 + c] = level[i * channels + (channels == 1 ? 0 : c)];
+      rgba[i * 4 + 3] = 255;
+    }
+    level = std::move(rgba);
+    channels = 4;
+  }
+
+  bool premultiplied = premultiplyAlpha && channels == 4;
+
+  // Premultiply before filtering so transparent texels don't bleed color into mips
+  if (premultiplied)
+  {
+    for (size_t i = 0; i < level.size(); i += 4)
+    {
+      unsigned int alpha = level[i + 3];
+      for (int c = 0; c < 3; c++)
+        level[i + c] = (unsigned char)((level[i + c] * alpha + 127) / 255);
+    }
+  }
+
+  // Build the whole chain down to 1x1
+  std::vector<std::vector<unsigned char>> levels;
+  std::vector<std::pair<int, int>> sizes;
+  int width = image.width, height = image.height;
+  levels.push_back(level);
+  sizes.emplace_back(width, height);
+  while (width > 1 || height > 1)
+  {
+    int nextWidth, nextHeight;
+    levels.push_back(downsample(levels.back(), width, height, channels, nextWidth, nextHeight));
+    width = nextWidth;
+    height = nextHeight;
+    sizes.emplace_back(width, height);
+  }
+
+  if (maxError)
+    *maxError = 0;
+  if (format != BAKED_FORMAT_RAW)
+  {
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+      std::vector<unsigned char> encoded;
+      int levelError = 0;
+      if (!TextureCodec::encode(format, levels[i].data(), sizes[i].first, sizes[i].second, encoded, levelError))
+        return false;
+      levels[i] = std::move(encoded);
+      if (maxError)
+        *maxError = std::max(*maxError, levelError);
+    }
+  }
+
+  BakedTextureHeader header = {};
+  memcpy(header.magic, "LTEX", 4);
+  header.version = VERSION;
+  header.width = (uint32_t)image.width;
+  header.height = (uint32_t)image.height;
+  header.channels = (uint32_t)channels;
+  header.mipCount = (uint32_t)levels.size();
+  header.flags = premultiplied ? (uint32_t)BAKED_PREMULTIPLIED_ALPHA : 0u;
+  header.format = format;
+
+  std::vector<BakedMipLevel> table(levels.size());
+  uint64_t offset = alignUp(sizeof(BakedTextureHeader) + table.size() * sizeof(BakedMipLevel));
+  for (size_t i = 0; i < levels.size(); i++)
+  {
+    table[i].width = (uint32_t)sizes[i].first;
+    table[i].height = (uint32_t)sizes[i].second;
+    table[i].offset = offset;
+    table[i].size = levels[i].size();
+    offset = alignUp(offset + levels[i].size());
+  }
+
+  out.assign((size_t)offset, 0);
+  memcpy(out.data(), &header, sizeof(header));
+  memcpy(out.data() + sizeof(header), table.data(), table.size() * sizeof(BakedMipLevel));
+  for (size_t i = 0; i < levels.size(); i++)
+    memcpy(out.data() + table[i].offset, levels[i].data(), levels[i].size());
+
+  return true;
+}
+
+bool BakedTexture::validate(const unsigned char* data, size_t size)
+{
+  if (!data || size < sizeof(BakedTextureHeader))
+    return false;
+
+  BakedTextureHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, "LTEX", 4) != 0 || header.version != VERSION)
+    return false;
+  if (header.channels != 1 && header.channels != 3 && header.channels != 4)
+    return false;
+  if (header.format > BAKED_FORMAT_ETC2 || (header.format != BAKED_FORMAT_RAW && header.channels != 4))
+    return false;
+  if (header.mipCount == 0 || header.mipCount > 32)
+    return false;
+  if (sizeof(header) + (size_t)header.mipCount * sizeof(BakedMipLevel) > size)
+    return false;
+
+  const BakedMipLevel* table = (const BakedMipLevel*)(data + sizeof(header));
+  for (uint32_t i = 0; i < header.mipCount; i++)
+  {
+    uint64_t expected = levelSize(header.format, table[i].width, table[i].height, header.channels);
+    if (table[i].size != expected || table[i].offset > size || table[i].size > size - table[i].offset)
+      return false;
+  }
+  return true;
+}
+
+unsigned int BakedTexture::upload(const unsigned char* data, size_t size)
+{
+  if (!validate(data, size))
+    return 0;
+
+  const BakedTextureHeader* header = (const BakedTextureHeader*)data;
+  const BakedMipLevel* table = (const BakedMipLevel*)(data + sizeof(BakedTextureHeader));
+  GLenum format = formatForChannels(header->channels);
+
+  // Let the caller fall back to another variant
+  if (!isFormatSupported(header->format))
+    return 0;
+
+  unsigned int textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  // Levels come pre-filtered, so no glGenerateMipmap
+  for (uint32_t i = 0; i < header->mipCount; i++)
+  {
+    if (header->format == BAKED_FORMAT_RAW)
+    {
+      glTexImage2D(GL_TEXTURE_2D, (GLint)i, format, table[i].width, table[i].height, 0, format, GL_UNSIGNED_BYTE,
+        data + table[i].offset);
+    }
+    else
+    {
+      glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, compressedInternalFormat(header->format),
+        table[i].width, table[i].height, 0, (GLsizei)table[i].size, data + table[i].offset);
+    }
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)header->mipCount - 1);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header->mipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  return textureID;
+}
+
+unsigned int BakedTexture::loadFile(const char* path, bool* premultiplied)
+{
+  MappedFile file;
+  if (!file.open(path))
+    return 0;
+
+  // The driver has copied the pixels once glTexImage2D returns, so the mapping can go
+  unsigned int textureID = upload(file.data(), file.size());
+  if (textureID != 0 && premultiplied)
+    *premultiplied = isPremultiplied(file.data(), file.size());
+  return textureID;
+}
+
+bool BakedTexture::isPremultiplied(const unsigned char* data, size_t size)
+{
+  if (!validate(data, size))
+    return false;
+
+  BakedTextureHeader header;
+  memcpy(&header, data, sizeof(header));
+  return (header.flags & BAKED_PREMULTIPLIED_ALPHA) != 0;
+}
+
+std::string BakedTexture::bakedPathFor(const std::string& sourcePath, BakedTextureFormat format)
+{
+  std::string extension = format == BAKED_FORMAT_RAW ? ".ltex" : std::string(".") + formatName(format) + ".ltex";
+
+  size_t slash = sourcePath.find_last_of("/\\");
+  size_t dot = sourcePath.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    return sourcePath + extension;
+  return sourcePath.substr(0, dot) + extension;
+}
+
+std::vector<std::string> BakedTexture::candidatePathsFor(const std::string& sourcePath)
+{
+  // BC formats first: desktop drivers often decompress ETC2 in software
+  std::vector<std::string> paths;
+  const CompressedTextureSupport& support = querySupport();
+  if (support.bc7)
+    paths.push_back(bakedPathFor(sourcePath, BAKED_FORMAT_BC7));
+  if (support.bc3)
+    paths.push_back(bakedPathFor(sourcePath, BAKED_FORMAT_BC3));
+  if (support.etc2)
+    paths.push_back(bakedPathFor(sourcePath, BAKED_FORMAT_ETC2));
+  paths.push_back(bakedPathFor(sourcePath, BAKED_FORMAT_RAW));
+  return paths;
+}
+
+const CompressedTextureSupport& BakedTexture::querySupport()
+{
+  static const CompressedTextureSupport support = detectSupport();
+  return support;
+}
+
+const char* BakedTexture::formatName(BakedTextureFormat format)
+{
+  switch (format)
+  {
+  case BAKED_FORMAT_BC3: return "bc3";
+  case BAKED_FORMAT_BC7: return "bc7";
+  case BAKED_FORMAT_ETC2: return "etc2";
+  default: return "raw";
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ImageData;
+
+// .ltex baked texture container, little-endian:
+//   BakedTextureHeader
+//   BakedMipLevel[mipCount]
+//   Pixel data for every level (16-byte aligned, rows bottom-up as OpenGL expects)
+// The whole file is mmap'd and each level is uploaded straight from the mapping.
+// Block-compressed variants sit next to the raw one (llama.bc7.ltex, llama.etc2.ltex, ...)
+// and the loader picks the best one the driver supports.
+struct BakedTextureHeader {
+  char magic[4];        // "LTEX"
+  uint32_t version;
+  uint32_t width;       // Base level size
+  uint32_t height;
+  uint32_t channels;    // 1, 3 or 4
+  uint32_t mipCount;    // Stored levels, base level included
+  uint32_t flags;       // BakedTextureFlags
+  uint32_t format;      // BakedTextureFormat
+};
+
+struct BakedMipLevel {
+  uint32_t width;
+  uint32_t height;
+  uint64_t offset;      // From the start of the file
+  uint64_t size;        // In bytes
+};
+
+enum BakedTextureFlags : uint32_t {
+  // Color is premultiplied by alpha; draw with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+  BAKED_PREMULTIPLIED_ALPHA = 1u << 0
+};
+
+enum BakedTextureFormat : uint32_t {
+  BAKED_FORMAT_RAW = 0,   // Uncompressed, 1/3/4 channels
+  BAKED_FORMAT_BC3 = 1,   // DXT5 (EXT_texture_compression_s3tc)
+  BAKED_FORMAT_BC7 = 2,   // BPTC (ARB_texture_compression_bptc, core in GL 4.2)
+  BAKED_FORMAT_ETC2 = 3   // ETC2 RGBA8 + EAC alpha (ARB_ES3_compatibility, core in GL 4.3)
+};
+
+// Compressed formats the current GL context can sample
+struct CompressedTextureSupport {
+  bool bc3 = false;
+  bool bc7 = false;
+  bool etc2 = false;
+};
+
+static_assert(sizeof(BakedTextureHeader) == 32, "BakedTextureHeader layout is part of the file format");
+static_assert(sizeof(BakedMipLevel) == 24, "BakedMipLevel layout is part of the file format");
+
+// Builds and loads .ltex files (see the asset_tool "bake" command)
+class BakedTexture
+{
+public:
+  static const uint32_t VERSION = 1;
+
+  // Build a container with a full box-filtered mip chain from decoded pixels.
+  // Compressed formats are encoded from RGBA; maxError (optional) receives the largest
+  // per-channel error over all levels.
+  static bool bake(const ImageData& image, bool premultiplyAlpha, std::vector<unsigned char>& out,
+    BakedTextureFormat format = BAKED_FORMAT_RAW, int* maxError = nullptr);
+
+  // Check that a container held in memory is complete and consistent
+  static bool validate(const unsigned char* data, size_t size);
+
+  // Upload every level straight from memory such as a file mapping (GL thread only)
+  static unsigned int upload(const unsigned char* data, size_t size);
+
+  // Map and upload a .ltex file; returns 0 if it is missing or invalid. premultiplied
+  // (optional) receives whether the file was baked with BAKED_PREMULTIPLIED_ALPHA.
+  static unsigned int loadFile(const char* path, bool* premultiplied = nullptr);
+
+  // Whether a valid container holds premultiplied color
+  static bool isPremultiplied(const unsigned char* data, size_t size);
+
+  // Where the baked version of a source image lives (assets/llama.png -> assets/llama.ltex,
+  // or assets/llama.bc7.ltex for a compressed variant)
+  static std::string bakedPathFor(const std::string& sourcePath, BakedTextureFormat format = BAKED_FORMAT_RAW);
+
+  // Baked files to try for a source image, best supported format first, raw last
+  static std::vector<std::string> candidatePathsFor(const std::string& sourcePath);
+
+  // Query compressed-format support. The first call must happen on the GL thread;
+  // later calls (from any thread) return the cached result.
+  static const CompressedTextureSupport& querySupport();
+
+  // Short name used in file names and tool options ("bc7", ...)
+  static const char* formatName(BakedTextureFormat format);
+};
@@ -0,0 +1,1156 @@
+// benchmarks.cpp : CPU micro-benchmarks for gameplay systems (no window or GL context needed).
+//
+// Usage:
+//   learn_open_gl_bench [name-filter]
+//
+#include "enemy.h"
+#include "projectile.h"
+#include "emitter.h"
+#include "ecs.h"
+#include "game_systems.h"
+#include "rng.h"
+#include "fast_math.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double millisecondsSince(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  // Game code reports hits on std::cout; keep benchmark output readable
+  class ScopedSilence
+  {
+  public:
+    ScopedSilence() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~ScopedSilence() { std::cout.rdbuf(previous); }
+
+  private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+  };
+
+  // Enemy record as stored before the entity world: one array of structs with a flag
+  struct LegacyEnemy {
+    float x, y;
+    float velX, velY;
+    float life;
+    int frame;
+    int hitPoints;
+    bool isAlive;
+    float spawnEffect;
+
+    LegacyEnemy(float startX, float startY, float vx, float vy)
+      : x(startX), y(startY), velX(vx), velY(vy), life(0.0f), frame(0), hitPoints(3), isAlive(true), spawnEffect(0.0f) {}
+
+    void takeDamage(int damage)
+    {
+      hitPoints -= damage;
+      if (hitPoints <= 0)
+        isAlive = false;
+    }
+  };
+
+  // Per-enemy update shared by both array-of-structs versions: one pass doing movement, aging,
+  // animation and wrapping together
+  void legacyMoveEnemies(std::vector<LegacyEnemy>& enemies, float deltaTime)
+  {
+    for (auto& enemy : enemies)
+    {
+      if (!enemy.isAlive) continue;
+      enemy.x += enemy.velX * deltaTime;
+      enemy.y += enemy.velY * deltaTime;
+      enemy.life += deltaTime;
+      enemy.spawnEffect += deltaTime;
+      enemy.frame = (int)(enemy.life * 8.0f) % DinoSpriteSheet::frameCount;
+      if (enemy.x > 5.0f) enemy.x = -5.0f;
+      if (enemy.x < -5.0f) enemy.x = 5.0f;
+      if (enemy.y > 5.0f) enemy.y = -5.0f;
+      if (enemy.y < -5.0f) enemy.y = 5.0f;
+    }
+  }
+
+  // EnemyManager::update as it was before incremental tracking: a full count and a full
+  // compaction every frame
+  void legacyEnemyUpdate(std::vector<LegacyEnemy>& enemies, float deltaTime, size_t maxEnemies, std::mt19937& gen)
+  {
+    size_t alive = std::count_if(enemies.begin(), enemies.end(), [](const LegacyEnemy& e) { return e.isAlive; });
+    std::uniform_real_distribution<float> position(-2.2f, 2.2f);
+    if (alive < maxEnemies)
+      enemies.emplace_back(position(gen), position(gen), 0.1f, 0.1f);
+
+    legacyMoveEnemies(enemies, deltaTime);
+
+    enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const LegacyEnemy& e) { return !e.isAlive; }),
+      enemies.end());
+  }
+
+  // EnemyManager as it was between incremental tracking and the entity world: the alive count
+  // and a dead-slot list follow kills and spawns, spawns refill dead slots, and the array is
+  // compacted only once at least 64 slots and over a quarter of them are dead
+  struct IncrementalEnemies {
+    std::vector<LegacyEnemy> enemies;
+    std::vector<size_t> deadSlots;
+    size_t aliveCount = 0;
+
+    void spawn(float x, float y)
+    {
+      if (!deadSlots.empty())
+      {
+        enemies[deadSlots.back()] = LegacyEnemy(x, y, 0.1f, 0.1f);
+        deadSlots.pop_back();
+      }
+      else
+      {
+        enemies.emplace_back(x, y, 0.1f, 0.1f);
+      }
+      aliveCount++;
+    }
+
+    void kill(size_t index)
+    {
+      if (!enemies[index].isAlive)
+        return;
+      enemies[index].takeDamage(3);
+      aliveCount--;
+      deadSlots.push_back(index);
+    }
+
+    void update(float deltaTime, size_t maxEnemies, std::mt19937& gen)
+    {
+      std::uniform_real_distribution<float> position(-2.2f, 2.2f);
+      if (aliveCount < maxEnemies)
+        spawn(position(gen), position(gen));
+
+      legacyMoveEnemies(enemies, deltaTime);
+
+      if (deadSlots.size() >= 64 && deadSlots.size() > enemies.size() / 4)
+      {
+        enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [](const LegacyEnemy& e) { return !e.isAlive; }),
+          enemies.end());
+        deadSlots.clear();
+      }
+    }
+  };
+
+  const size_t BOOKKEEPING_ENEMIES = 100000;
+  const int BOOKKEEPING_FRAMES = 600;
+  const float BOOKKEEPING_DELTA = 1.0f / 60.0f;
+
+  // Average update time of the old full-scan bookkeeping
+  double runLegacyBookkeeping(int killsPerFrame)
+  {
+    std::mt19937 gen(1234);
+    std::vector<LegacyEnemy> enemies;
+    enemies.reserve(BOOKKEEPING_ENEMIES + 1);
+    std::uniform_real_distribution<float> position(-2.2f, 2.2f);
+    for (size_t i = 0; i < BOOKKEEPING_ENEMIES; i++)
+      enemies.emplace_back(position(gen), position(gen), 0.1f, 0.1f);
+
+    double totalMs = 0.0;
+    for (int frame = 0; frame < BOOKKEEPING_FRAMES; frame++)
+    {
+      for (int k = 0; k < killsPerFrame; k++)
+        enemies[gen() % enemies.size()].takeDamage(3);
+
+      auto start = Clock::now();
+      legacyEnemyUpdate(enemies, BOOKKEEPING_DELTA, BOOKKEEPING_ENEMIES, gen);
+      totalMs += millisecondsSince(start);
+    }
+    return totalMs / BOOKKEEPING_FRAMES;
+  }
+
+  // Average update time of the incremental bookkeeping, on the same kills
+  double runIncrementalBookkeeping(int killsPerFrame)
+  {
+    std::mt19937 gen(1234);
+    IncrementalEnemies enemies;
+    enemies.enemies.reserve(BOOKKEEPING_ENEMIES + 1);
+    std::uniform_real_distribution<float> position(-2.2f, 2.2f);
+    for (size_t i = 0; i < BOOKKEEPING_ENEMIES; i++)
+      enemies.spawn(position(gen), position(gen));
+
+    double totalMs = 0.0;
+    for (int frame = 0; frame < BOOKKEEPING_FRAMES; frame++)
+    {
+      for (int k = 0; k < killsPerFrame; k++)
+        enemies.kill(gen() % enemies.enemies.size());
+
+      auto start = Clock::now();
+      enemies.update(BOOKKEEPING_DELTA, BOOKKEEPING_ENEMIES, gen);
+      totalMs += millisecondsSince(start);
+    }
+    return totalMs / BOOKKEEPING_FRAMES;
+  }
+
+  // Average time of the enemy systems on the entity world, and of EnemyManager::update among
+  // them (spawning plus flow field steering, which the array versions above never had)
+  double runWorldBookkeeping(int killsPerFrame, double& updateMs)
+  {
+    ScopedSilence silence;
+    std::mt19937 gen(1234);
+    World world;
+    EnemyManager manager(world);
+    manager.setMaxEnemies((int)BOOKKEEPING_ENEMIES);
+    manager.setSpawnRate(1.0f / BOOKKEEPING_DELTA); // One spawn per frame, like the baseline
+    manager.setCrowdSteering(false);   // Not part of the baseline; see the crowd benchmark
+    for (size_t i = 0; i < BOOKKEEPING_ENEMIES; i++)
+      manager.spawnEnemyAtRandomLocation();
+
+    // The same work the game schedules for enemies
+    updateMs = 0.0;
+    SystemScheduler systems;
+    systems.add("Enemy update", [&manager, &updateMs](World&, float dt) {
+      auto start = Clock::now();
+      manager.update(dt);
+      updateMs += millisecondsSince(start);
+    });
+    systems.add("Integrate", GameSystems::integrate);
+
+    // Kill targets are picked by dense position; with a single archetype that is chunk-major
+    std::vector<Position> positions;
+    double totalMs = 0.0;
+    for (int frame = 0; frame < BOOKKEEPING_FRAMES; frame++)
+    {
+      // Three hits kill; not timed, since the hit test itself is a linear scan
+      positions.clear();
+      world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+        positions.insert(positions.end(), chunk.get<Position>(), chunk.get<Position>() + chunk.size());
+      });
+      for (int k = 0; k < killsPerFrame; k++)
+      {
+        Position target = positions[gen() % positions.size()];
+        for (int hit = 0; hit < 3; hit++)
+          manager.checkProjectileCollisions(target.x, target.y);
+      }
+
+      auto start = Clock::now();
+      systems.run(world, BOOKKEEPING_DELTA);
+      totalMs += millisecondsSince(start);
+    }
+    updateMs /= BOOKKEEPING_FRAMES;
+    return totalMs / BOOKKEEPING_FRAMES;
+  }
+
+  // 100k enemies, a few kills per frame and one spawn per frame to refill
+  void benchEnemyBookkeeping()
+  {
+    for (int killsPerFrame : { 0, 1, 10, 100 })
+    {
+      double legacyMs = runLegacyBookkeeping(killsPerFrame);
+      double incrementalMs = runIncrementalBookkeeping(killsPerFrame);
+      double updateMs;
+      double worldMs = runWorldBookkeeping(killsPerFrame, updateMs);
+      std::cout << "  kills/frame " << killsPerFrame << ": full scan " << legacyMs << " ms/frame, incremental "
+        << incrementalMs << " ms/frame, entity world " << worldMs << " ms/frame (" << updateMs
+        << " in EnemyManager::update, " << worldMs - updateMs << " in the integrate system)" << std::endl;
+    }
+  }
+
+  const size_t SPAWN_WAVE = 10000;
+  const int SPAWN_WAVES = 50;
+
+  // One wave of single spawns vs one burst, each into an empty world
+  void benchSpawnBurst()
+  {
+    double singleMs = 0.0, screenMs = 0.0, ringMs = 0.0;
+    for (int wave = 0; wave < SPAWN_WAVES; wave++)
+    {
+      ScopedSilence silence;
+      {
+        World world;
+        EnemyManager manager(world);
+        manager.setMaxEnemies((int)SPAWN_WAVE);
+        auto start = Clock::now();
+        for (size_t i = 0; i < SPAWN_WAVE; i++)
+          manager.spawnEnemyAtRandomLocation();
+        singleMs += millisecondsSince(start);
+      }
+      {
+        World world;
+        EnemyManager manager(world);
+        manager.setMaxEnemies((int)SPAWN_WAVE);
+        auto start = Clock::now();
+        manager.spawnBurst(SPAWN_WAVE, SpawnPattern::ScreenArea);
+        screenMs += millisecondsSince(start);
+      }
+      {
+        World world;
+        EnemyManager manager(world);
+        manager.setMaxEnemies((int)SPAWN_WAVE);
+        auto start = Clock::now();
+        manager.spawnBurst(SPAWN_WAVE, SpawnPattern::Ring);
+        ringMs += millisecondsSince(start);
+      }
+    }
+    std::cout << "  " << SPAWN_WAVE << " enemies: single spawns " << singleMs / SPAWN_WAVES << " ms, burst (screen area) "
+      << screenMs / SPAWN_WAVES << " ms, burst (ring) " << ringMs / SPAWN_WAVES << " ms" << std::endl;
+  }
+
+  const int EMITTER_FRAMES = 600;
+
+  // Steady-state frame cost with the stress emitter (~12k shots per second, ~60k live)
+  void benchEmitters()
+  {
+    for (int batched = 0; batched < 2; batched++)
+    {
+      World world;
+      ProjectileManager projectiles(world);
+      EmitterSystem emitters(world, projectiles);
+      Emitter emitter{ EmitterDesc(), 0.0f, 0.0f };
+      emitter.desc.loadPreset("stress");
+      world.create(Position{ 0.0f, 0.0f }, Rotation{ 0.0f }, emitter);
+
+      // Baseline: the same shots one addProjectileWithSpray call at a time
+      Rng rng(1);
+      float shotTimer = 0.0f;
+      auto shootOneByOne = [&](World&, float dt) {
+        const EmitterDesc& desc = emitter.desc;
+        for (shotTimer += dt; shotTimer >= 1.0f / desc.rate; shotTimer -= 1.0f / desc.rate)
+        {
+          for (int k = 0; k < desc.count; k++)
+            projectiles.addProjectileWithSpray(0.0f, 0.0f, rng.uniform(0.0f, 6.2831853f), desc.speed, desc.sprayPercent);
+        }
+      };
+
+      // Emission is timed on its own as well, since moving 60k projectiles dominates the frame
+      double emitMs = 0.0;
+      auto timedEmit = [&](World& w, float dt) {
+        auto start = Clock::now();
+        if (batched)
+          emitters.update(dt);
+        else
+          shootOneByOne(w, dt);
+        emitMs += millisecondsSince(start);
+      };
+
+      SystemScheduler systems;
+      systems.add("Integrate", GameSystems::integrate);
+      systems.add("Emit", timedEmit);
+      systems.add("Expiry", GameSystems::expiry);
+
+      double frameMs = 0.0;
+      for (int frame = 0; frame < EMITTER_FRAMES; frame++)
+      {
+        if (frame == EMITTER_FRAMES / 2)
+          emitMs = 0.0;   // Measure the second half, at steady state
+        auto start = Clock::now();
+        systems.run(world, BOOKKEEPING_DELTA);
+        if (frame >= EMITTER_FRAMES / 2)
+          frameMs += millisecondsSince(start);
+      }
+      int measured = EMITTER_FRAMES / 2;
+      std::cout << "  " << (batched ? "emitter batches" : "addProjectileWithSpray") << ": "
+        << projectiles.getProjectileCount() << " live, " << frameMs / measured << " ms/frame, emission "
+        << emitMs / measured << " ms/frame" << std::endl;
+    }
+  }
+
+  const float COLLISION_SECONDS = 4.0f;
+  const size_t COLLISION_ENEMIES = 300;
+  const size_t COLLISION_VOLLEY = 60;
+  const float COLLISION_VOLLEY_RATE = 2.0f;
+  const float COLLISION_SHOT_SPEED = 20.0f;
+
+  // Headless run: a ring of enemies around fast ring volleys fired from the center, simulated
+  // at stepHz. Returns hits landed; frameMs gets the mean collision cost per frame.
+  size_t runCollisionSim(float stepHz, bool swept, double& frameMs)
+  {
+    Random::setGlobalSeed(1);
+    World world;
+    EnemyManager enemies(world);
+    ProjectileManager projectiles(world);
+    enemies.setMaxEnemies((int)COLLISION_ENEMIES);
+    enemies.spawnBurst(COLLISION_ENEMIES, SpawnPattern::Ring);
+
+    std::vector<float> xs(COLLISION_VOLLEY, 0.0f), ys(COLLISION_VOLLEY, 0.0f), angles(COLLISION_VOLLEY);
+    std::vector<float> speeds(COLLISION_VOLLEY, COLLISION_SHOT_SPEED), ages(COLLISION_VOLLEY);
+    for (size_t i = 0; i < COLLISION_VOLLEY; i++)
+      angles[i] = 2.0f * 3.14159265f * i / COLLISION_VOLLEY;
+
+    float deltaTime = 1.0f / stepHz;
+    int frames = (int)(COLLISION_SECONDS * stepHz);
+    float time = 0.0f, nextVolley = 0.0f;
+    size_t hits = 0;
+    double collisionMs = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      time += deltaTime;
+      GameSystems::movement(world, deltaTime);
+      GameSystems::aging(world, deltaTime);
+      GameSystems::screenWrap(world, deltaTime);
+      for (; nextVolley <= time; nextVolley += 1.0f / COLLISION_VOLLEY_RATE)
+      {
+        std::fill(ages.begin(), ages.end(), time - nextVolley);
+        projectiles.spawnBatch(COLLISION_VOLLEY, xs.data(), ys.data(), angles.data(), speeds.data(), ages.data());
+      }
+
+      size_t before = projectiles.getProjectileCount();
+      auto start = Clock::now();
+      if (swept)
+      {
+        projectiles.update(deltaTime, &enemies);
+      }
+      else
+      {
+        // Discrete test at the end of the frame, as before swept collision, with the same
+        // projectile radius as the swept test
+        world.forEachChunk<Position, ProjectileBody>([&](ChunkView chunk) {
+          const Position* position = chunk.get<Position>();
+          const ProjectileBody* body = chunk.get<ProjectileBody>();
+          const Entity* entities = chunk.entities();
+          for (size_t i = 0, n = chunk.size(); i < n; i++)
+          {
+            if (enemies.checkProjectileCollisions(position[i].x, position[i].y, body[i].radius))
+              world.destroyDeferred(entities[i]);
+          }
+        });
+        world.flushDestroyed();
+      }
+      collisionMs += millisecondsSince(start);
+      hits += before - projectiles.getProjectileCount();
+
+      GameSystems::expiry(world, deltaTime);
+      world.flushDestroyed();
+    }
+    frameMs = collisionMs / frames;
+    return hits;
+  }
+
+  // The same simulated seconds at several rates; end-of-frame point tests miss more and more
+  // as steps get longer, swept tests should land about the same hits at every rate
+  void benchSweptCollision()
+  {
+    for (float stepHz : { 240.0f, 60.0f, 15.0f, 4.0f })
+    {
+      double pointMs, sweptMs;
+      size_t pointHits, sweptHits;
+      {
+        ScopedSilence silence;
+        pointHits = runCollisionSim(stepHz, false, pointMs);
+        sweptHits = runCollisionSim(stepHz, true, sweptMs);
+      }
+      std::cout << "  " << stepHz << " Hz: point " << pointHits << " hits, " << pointMs << " ms/frame; swept "
+        << sweptHits << " hits, " << sweptMs << " ms/frame" << std::endl;
+    }
+  }
+
+  const size_t BROADPHASE_ENEMIES = 5000;
+  const size_t BROADPHASE_SHOTS = 2000;
+  const int BROADPHASE_FRAMES = 60;
+
+  enum class Distribution { Uniform, Clustered, Ring };
+
+  // Enemies placed by distribution and a fixed set of shots crossing the screen; each frame
+  // moves everything, prepares the colliders and finds every shot's first hit.
+  // Returns ms per frame for prepare + sweeps; swaps gets the mean insertion sort swaps and
+  // firstHits every shot's hit, frame by frame (the same run gives the same handles).
+  double runBroadphase(Distribution distribution, CollisionBackend backend, size_t& hits, double& swaps,
+    std::vector<EnemyHandle>& firstHits)
+  {
+    Random::setGlobalSeed(1);
+    Rng rng(42);
+    World world;
+    EnemyManager enemies(world);
+    enemies.setMaxEnemies((int)BROADPHASE_ENEMIES);
+    enemies.setCollisionBackend(backend);
+
+    if (distribution == Distribution::Ring)
+    {
+      enemies.spawnBurst(BROADPHASE_ENEMIES, SpawnPattern::Ring);
+    }
+    else
+    {
+      for (size_t i = 0; i < BROADPHASE_ENEMIES; i++)
+      {
+        float x, y;
+        if (distribution == Distribution::Uniform)
+        {
+          x = rng.uniform(-2.2f, 2.2f);
+          y = rng.uniform(-2.2f, 2.2f);
+        }
+        else
+        {
+          // Converging on the player, as enemies heading for the center end up
+          float radius = 0.4f * std::sqrt(rng.nextFloat());
+          float angle = rng.uniform(-3.14159265f, 3.14159265f);
+          x = radius * std::cos(angle);
+          y = radius * std::sin(angle);
+        }
+        float heading = rng.uniform(-3.14159265f, 3.14159265f);
+        float speed = rng.uniform(0.1f, 0.3f);
+        enemies.spawnEnemy(x, y, std::cos(heading) * speed, std::sin(heading) * speed);
+      }
+    }
+    std::vector<float> shotX(BROADPHASE_SHOTS), shotY(BROADPHASE_SHOTS), shotVelX(BROADPHASE_SHOTS), shotVelY(BROADPHASE_SHOTS);
+    for (size_t i = 0; i < BROADPHASE_SHOTS; i++)
+    {
+      float heading = rng.uniform(-3.14159265f, 3.14159265f);
+      shotX[i] = rng.uniform(-2.5f, 2.5f);
+      shotY[i] = rng.uniform(-2.5f, 2.5f);
+      shotVelX[i] = std::cos(heading) * 1.5f;
+      shotVelY[i] = std::sin(heading) * 1.5f;
+    }
+
+    hits = 0;
+    swaps = 0.0;
+    firstHits.resize(BROADPHASE_SHOTS * BROADPHASE_FRAMES);
+    double ms = 0.0;
+    for (int frame = 0; frame < BROADPHASE_FRAMES; frame++)
+    {
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+      for (size_t i = 0; i < BROADPHASE_SHOTS; i++)
+      {
+        // Wrap shots around the screen instead of expiring them
+        shotX[i] = std::fmod(shotX[i] + shotVelX[i] * BOOKKEEPING_DELTA + 7.5f, 5.0f) - 2.5f;
+        shotY[i] = std::fmod(shotY[i] + shotVelY[i] * BOOKKEEPING_DELTA + 7.5f, 5.0f) - 2.5f;
+      }
+
+      EnemyHandle* frameHits = firstHits.data() + frame * BROADPHASE_SHOTS;
+      auto start = Clock::now();
+      enemies.prepareCollision(BOOKKEEPING_DELTA);
+      for (size_t i = 0; i < BROADPHASE_SHOTS; i++)
+      {
+        frameHits[i] = enemies.findFirstHit(shotX[i], shotY[i], shotVelX[i], shotVelY[i], BOOKKEEPING_DELTA);
+        hits += !frameHits[i].isNull();
+      }
+      ms += millisecondsSince(start);
+      swaps += (double)enemies.getLastSweepSwapCount();
+    }
+    swaps /= BROADPHASE_FRAMES;
+    return ms / BROADPHASE_FRAMES;
+  }
+
+  void benchBroadphase()
+  {
+    const std::pair<Distribution, const char*> distributions[] = {
+      { Distribution::Uniform, "uniform" }, { Distribution::Clustered, "clustered" }, { Distribution::Ring, "ring" } };
+    for (const auto& distribution : distributions)
+    {
+      // Brute force runs first: every other backend must find the same first hit for every shot
+      std::vector<EnemyHandle> reference, firstHits;
+      size_t bruteHits;
+      double bruteSwaps;
+      double bruteMs = runBroadphase(distribution.first, CollisionBackend::BruteForce, bruteHits, bruteSwaps, reference);
+
+      std::cout << "  " << distribution.second << ":";
+      for (CollisionBackend backend : { CollisionBackend::Grid, CollisionBackend::SweepAndPrune })
+      {
+        size_t hits;
+        double swaps;
+        double ms = runBroadphase(distribution.first, backend, hits, swaps, firstHits);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < firstHits.size(); i++)
+          mismatches += firstHits[i] != reference[i];
+        std::cout << " " << getCollisionBackendName(backend) << " " << ms << " ms (" << hits << " hits, "
+          << mismatches << " mismatches";
+        if (backend == CollisionBackend::SweepAndPrune)
+          std::cout << ", " << swaps << " swaps";
+        std::cout << ")";
+      }
+      std::cout << " " << getCollisionBackendName(CollisionBackend::BruteForce) << " " << bruteMs << " ms ("
+        << bruteHits << " hits)" << std::endl;
+    }
+  }
+
+  const size_t FLOW_ENEMIES = 100000;
+  const int FLOW_FRAMES = 300;
+
+  // 100k enemies: straight-line movement alone vs flow field steering plus movement, and the
+  // cost of a field rebuild when the target changes cell
+  void benchFlowField()
+  {
+    World world;
+    EnemyManager enemies(world);
+    enemies.setMaxEnemies((int)FLOW_ENEMIES);
+    enemies.setSpawnRate(0.001f);
+    enemies.setCrowdSteering(false);
+    enemies.spawnBurst(FLOW_ENEMIES, SpawnPattern::ScreenArea);
+    enemies.setTarget(0.0f, 0.0f);
+    enemies.update(BOOKKEEPING_DELTA);   // First build
+
+    auto start = Clock::now();
+    for (int frame = 0; frame < FLOW_FRAMES; frame++)
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+    double straightMs = millisecondsSince(start) / FLOW_FRAMES;
+
+    start = Clock::now();
+    for (int frame = 0; frame < FLOW_FRAMES; frame++)
+    {
+      enemies.update(BOOKKEEPING_DELTA);
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+    }
+    double steeredMs = millisecondsSince(start) / FLOW_FRAMES;
+
+    // Walk the target through a new cell every rebuild
+    FlowField& field = enemies.getFlowField();
+    const int rebuilds = 50;
+    start = Clock::now();
+    for (int i = 0; i < rebuilds; i++)
+    {
+      field.setTarget(-2.0f + i * field.getCellSize(), 0.0f);
+      field.update();
+    }
+    double rebuildMs = millisecondsSince(start) / rebuilds;
+
+    std::cout << "  " << FLOW_ENEMIES << " enemies: straight movement " << straightMs << " ms/frame, steering + movement "
+      << steeredMs << " ms/frame; " << field.getColumns() << "^2 field rebuild " << rebuildMs << " ms" << std::endl;
+  }
+
+  const size_t CROWD_SIZES[] = { 1000, 10000, 50000, 100000 };
+  const int CROWD_FRAMES = 120;
+  const float CROWDED_DISTANCE = 0.1f;
+
+  // Share of enemies with another enemy closer than CROWDED_DISTANCE
+  double crowdedShare(World& world)
+  {
+    std::vector<float> xs, ys;
+    world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+      const Position* position = chunk.get<Position>();
+      for (size_t i = 0, n = chunk.size(); i < n; i++)
+      {
+        xs.push_back(position[i].x);
+        ys.push_back(position[i].y);
+      }
+    });
+    SpatialGrid grid(CROWDED_DISTANCE);
+    grid.build(xs.data(), ys.data(), xs.data(), ys.data(), xs.size());
+    size_t crowded = 0;
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+      bool close = false;
+      grid.queryNeighbours(xs[i], ys[i], [&](const BoxSpan& cell) {
+        for (size_t k = 0; k < cell.count && !close; k++)
+        {
+          float dx = cell.minX[k] - xs[i], dy = cell.minY[k] - ys[i];
+          close = cell.items[k] != i && dx * dx + dy * dy < CROWDED_DISTANCE * CROWDED_DISTANCE;
+        }
+        return !close;
+      });
+      crowded += close;
+    }
+    return xs.empty() ? 0.0 : 100.0 * crowded / xs.size();
+  }
+
+  // Enemy update with and without crowd steering over CROWD_FRAMES frames of chasing a
+  // target at the center; returns ms per frame and how crowded the end state is
+  double runCrowd(size_t count, bool steering, double& crowded)
+  {
+    Random::setGlobalSeed(1);
+    World world;
+    EnemyManager enemies(world);
+    enemies.setMaxEnemies((int)count);
+    enemies.setSpawnRate(0.001f);
+    enemies.setCrowdSteering(steering);
+    enemies.spawnBurst(count, SpawnPattern::ScreenArea);
+    enemies.setTarget(0.0f, 0.0f);
+
+    double totalMs = 0.0;
+    for (int frame = 0; frame < CROWD_FRAMES; frame++)
+    {
+      auto start = Clock::now();
+      enemies.update(BOOKKEEPING_DELTA);
+      totalMs += millisecondsSince(start);
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+    }
+    crowded = crowdedShare(world);
+    return totalMs / CROWD_FRAMES;
+  }
+
+  // Cost of separation, alignment and cohesion as the crowd grows
+  void benchCrowd()
+  {
+    std::cout << "  " << JobPool().getThreadCount() << " threads, " << CrowdWeights().maxNeighbours
+      << " neighbours max" << std::endl;
+    for (size_t count : CROWD_SIZES)
+    {
+      double plainCrowded, steeredCrowded;
+      double plainMs = runCrowd(count, false, plainCrowded);
+      double steeredMs = runCrowd(count, true, steeredCrowded);
+      double crowdMs = steeredMs - plainMs;
+      std::cout << "  " << count << " enemies: enemy update " << plainMs << " -> " << steeredMs << " ms/frame (crowd "
+        << crowdMs << " ms, " << crowdMs * 1e6 / count << " ns/enemy); within " << CROWDED_DISTANCE << " of another: "
+        << plainCrowded << "% -> " << steeredCrowded << "%" << std::endl;
+    }
+  }
+
+  const size_t OVERLAP_SIZES[] = { 10000, 50000 };
+  const int OVERLAP_ITERATIONS[] = { 0, 1, 2, 4, 8 };
+  const int OVERLAP_FRAMES = 120;
+
+  // Enemies are shrunk so the crowd could cover this share of the spawn area without
+  // overlapping (full size, 50k would need some 4500 square units)
+  const float OVERLAP_PACKING = 0.5f;
+
+  // Share of enemies stacked on another: collision boxes overlapping by more than a quarter of
+  // their width on both axes
+  double overlappingShare(World& world)
+  {
+    std::vector<float> xs, ys;
+    float half = 0.0f;
+    world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+      const Position* position = chunk.get<Position>();
+      const EnemyBody* body = chunk.get<EnemyBody>();
+      for (size_t i = 0, n = chunk.size(); i < n; i++)
+      {
+        xs.push_back(position[i].x);
+        ys.push_back(position[i].y);
+        half = std::max(half, 0.15f * body[i].size);
+      }
+    });
+    float reach = 2.0f * half * 0.75f;
+    SpatialGrid grid(2.0f * half);
+    grid.build(xs.data(), ys.data(), xs.data(), ys.data(), xs.size());
+    size_t overlapping = 0;
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+      bool touching = false;
+      grid.queryNeighbours(xs[i], ys[i], [&](const BoxSpan& cell) {
+        for (size_t k = 0; k < cell.count && !touching; k++)
+        {
+          touching = cell.items[k] != i && std::fabs(cell.minX[k] - xs[i]) < reach &&
+            std::fabs(cell.minY[k] - ys[i]) < reach;
+        }
+        return !touching;
+      });
+      overlapping += touching;
+    }
+    return xs.empty() ? 0.0 : 100.0 * overlapping / xs.size();
+  }
+
+  // Enemies chasing a target at the center for OVERLAP_FRAMES frames with the overlap solver at
+  // the given iteration count (0: off); returns the solver's ms per frame
+  double runOverlap(size_t count, int iterations, double& overlapping)
+  {
+    Random::setGlobalSeed(1);
+    World world;
+    EnemyManager enemies(world);
+    enemies.setMaxEnemies((int)count);
+    enemies.setSpawnRate(0.001f);
+    enemies.setCrowdSteering(false);
+    enemies.setOverlapResolution(iterations > 0);
+    OverlapSettings settings;
+    settings.iterations = iterations;
+    enemies.getCrowd().setOverlapSettings(settings);
+    enemies.spawnBurst(count, SpawnPattern::ScreenArea);
+    enemies.setTarget(0.0f, 0.0f);
+
+    const float spawnArea = 4.4f * 4.4f - 1.6f * 1.6f;
+    float size = std::sqrt(OVERLAP_PACKING * spawnArea / count) / 0.3f;
+    world.each<EnemyBody>([&](Entity, EnemyBody& body) { body.size = size; });
+
+    double totalMs = 0.0;
+    for (int frame = 0; frame < OVERLAP_FRAMES; frame++)
+    {
+      enemies.update(BOOKKEEPING_DELTA);
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+      auto start = Clock::now();
+      enemies.resolveOverlaps();
+      totalMs += millisecondsSince(start);
+    }
+    overlapping = overlappingShare(world);
+    return totalMs / OVERLAP_FRAMES;
+  }
+
+  // Overlap solver cost and how much overlap is left, by crowd size and iteration budget
+  void benchOverlap()
+  {
+    std::cout << "  " << JobPool().getThreadCount() << " threads, " << OverlapSettings().maxContacts
+      << " contacts max, stacked enemies after " << OVERLAP_FRAMES << " frames" << std::endl;
+    for (size_t count : OVERLAP_SIZES)
+    {
+      std::cout << "  " << count << " enemies:";
+      for (int iterations : OVERLAP_ITERATIONS)
+      {
+        double overlapping;
+        double ms = runOverlap(count, iterations, overlapping);
+        if (iterations == 0)
+          std::cout << " off " << overlapping << "%";
+        else
+          std::cout << ", " << iterations << " iterations " << ms << " ms " << overlapping << "%";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  const size_t HOMING_ENEMIES = 50000;
+  const size_t HOMING_SHOTS = 10000;
+  const size_t HOMING_BRUTE_FORCE_SHOTS = 500;   // Brute force is timed on a subset and scaled up
+  const int HOMING_REPEATS = 20;
+  const int HOMING_FRAMES = 60;
+  const int HOMING_REFITS = 7;   // As many as EnemyManager runs between rebuilds
+
+  // Nearest-enemy lookups for homing shots: k-d tree build, refit and batched queries against
+  // a brute-force scan, then the whole steerHoming pass per frame (shots retarget every 0.25 s)
+  void benchHoming()
+  {
+    Random::setGlobalSeed(1);
+    World world;
+    EnemyManager enemies(world);
+    enemies.setMaxEnemies((int)HOMING_ENEMIES);
+    enemies.setSpawnRate(0.001f);
+    enemies.spawnBurst(HOMING_ENEMIES, SpawnPattern::ScreenArea);
+
+    std::vector<float> enemyX, enemyY, stepX, stepY;
+    world.forEachChunk<Position, Velocity, EnemyBody>([&](ChunkView chunk) {
+      const Position* position = chunk.get<Position>();
+      const Velocity* velocity = chunk.get<Velocity>();
+      for (size_t i = 0, n = chunk.size(); i < n; i++)
+      {
+        enemyX.push_back(position[i].x);
+        enemyY.push_back(position[i].y);
+        stepX.push_back(velocity[i].x * BOOKKEEPING_DELTA);
+        stepY.push_back(velocity[i].y * BOOKKEEPING_DELTA);
+      }
+    });
+
+    Rng rng(1234);
+    std::vector<float> shotX(HOMING_SHOTS), shotY(HOMING_SHOTS);
+    rng.fillUniform(shotX.data(), HOMING_SHOTS, -2.2f, 2.2f);
+    rng.fillUniform(shotY.data(), HOMING_SHOTS, -2.2f, 2.2f);
+    std::vector<uint32_t> nearest(HOMING_SHOTS);
+
+    // Cold: a fresh tree every time. Then the enemies walk a frame between calls, and the tree
+    // is refit to them (the queries below run on the last refit, against a brute-force scan)
+    // or rebuilt starting from the last build's order, as EnemyManager::prepareTargeting does.
+    auto start = Clock::now();
+    for (int r = 0; r < HOMING_REPEATS; r++)
+    {
+      KdTree cold;
+      cold.build(enemyX.data(), enemyY.data(), enemyX.size());
+    }
+    double coldMs = millisecondsSince(start) / HOMING_REPEATS;
+
+    auto walk = [&]() {
+      for (size_t i = 0; i < enemyX.size(); i++)
+      {
+        enemyX[i] += stepX[i];
+        enemyY[i] += stepY[i];
+      }
+    };
+
+    KdTree tree;
+    tree.build(enemyX.data(), enemyY.data(), enemyX.size());
+    double refitMs = 0.0;
+    for (int r = 0; r < HOMING_REFITS; r++)
+    {
+      walk();
+      start = Clock::now();
+      tree.refit(enemyX.data(), enemyY.data());
+      refitMs += millisecondsSince(start);
+    }
+    refitMs /= HOMING_REFITS;
+
+    start = Clock::now();
+    for (int r = 0; r < HOMING_REPEATS; r++)
+      tree.nearest(shotX.data(), shotY.data(), HOMING_SHOTS, nearest.data());
+    double queryMs = millisecondsSince(start) / HOMING_REPEATS;
+
+    JobPool jobs;
+    start = Clock::now();
+    for (int r = 0; r < HOMING_REPEATS; r++)
+      tree.nearest(shotX.data(), shotY.data(), HOMING_SHOTS, nearest.data(), &jobs);
+    double pooledMs = millisecondsSince(start) / HOMING_REPEATS;
+
+    size_t mismatches = 0;
+    start = Clock::now();
+    for (size_t q = 0; q < HOMING_BRUTE_FORCE_SHOTS; q++)
+    {
+      float best = INFINITY;
+      for (size_t i = 0; i < enemyX.size(); i++)
+      {
+        float dx = enemyX[i] - shotX[q], dy = enemyY[i] - shotY[q];
+        best = std::min(best, dx * dx + dy * dy);
+      }
+      float dx = enemyX[nearest[q]] - shotX[q], dy = enemyY[nearest[q]] - shotY[q];
+      mismatches += dx * dx + dy * dy != best;
+    }
+    double bruteMs = millisecondsSince(start) * HOMING_SHOTS / HOMING_BRUTE_FORCE_SHOTS;
+
+    double warmMs = 0.0;
+    for (int r = 0; r < HOMING_REPEATS; r++)
+    {
+      walk();
+      start = Clock::now();
+      tree.build(enemyX.data(), enemyY.data(), enemyX.size());
+      warmMs += millisecondsSince(start);
+    }
+    warmMs /= HOMING_REPEATS;
+
+    std::cout << "  " << HOMING_SHOTS << " queries, " << HOMING_ENEMIES << " enemies, " << jobs.getThreadCount()
+      << " threads" << std::endl;
+    std::cout << "  k-d tree build: " << coldMs << " ms cold, " << warmMs << " ms from the last frame's order, "
+      << refitMs << " ms refit" << std::endl;
+    std::cout << "  k-d tree queries: " << queryMs << " ms (" << pooledMs << " ms on the job pool) after "
+      << HOMING_REFITS << " refits" << std::endl;
+    std::cout << "  brute force: " << bruteMs << " ms (" << mismatches << " mismatches on "
+      << HOMING_BRUTE_FORCE_SHOTS << " checked)" << std::endl;
+
+    // Full pass: one volley fired from the centre at enemies walking at their spawn velocity,
+    // first with every shot's first lookup in the same frame (and every retarget after it),
+    // then with the first lookups spread over the interval as emitters do
+    ProjectileManager projectiles(world);
+    std::vector<float> zeros(HOMING_SHOTS, 0.0f), angles(HOMING_SHOTS), speeds(HOMING_SHOTS, 1.2f);
+    std::vector<float> turnRates(HOMING_SHOTS, 4.7f), retargets(HOMING_SHOTS, 0.25f), delays(HOMING_SHOTS);
+    rng.fillUniform(angles.data(), HOMING_SHOTS, -3.14159f, 3.14159f);
+    rng.fillUniform(delays.data(), HOMING_SHOTS, 0.0f, 0.25f);
+    for (bool staggered : { false, true })
+    {
+      projectiles.clear();
+      projectiles.spawnBatch(HOMING_SHOTS, zeros.data(), zeros.data(), angles.data(), speeds.data(), zeros.data(),
+        turnRates.data(), retargets.data(), staggered ? delays.data() : nullptr);
+
+      double steerMs = 0.0, worstMs = 0.0;
+      for (int frame = 0; frame < HOMING_FRAMES; frame++)
+      {
+        start = Clock::now();
+        projectiles.steerHoming(BOOKKEEPING_DELTA, &enemies);
+        double ms = millisecondsSince(start);
+        steerMs += ms;
+        worstMs = std::max(worstMs, ms);
+        world.forEachChunk<Position, Velocity>([&](ChunkView chunk) {
+          Position* position = chunk.get<Position>();
+          const Velocity* velocity = chunk.get<Velocity>();
+          for (size_t i = 0, n = chunk.size(); i < n; i++)
+          {
+            position[i].x += velocity[i].x * BOOKKEEPING_DELTA;
+            position[i].y += velocity[i].y * BOOKKEEPING_DELTA;
+          }
+        });
+      }
+      std::cout << "  steerHoming, " << (staggered ? "staggered" : "in step") << ": " << steerMs / HOMING_FRAMES
+        << " ms per frame, " << worstMs << " ms worst" << std::endl;
+    }
+  }
+
+  const size_t AREA_ENEMIES = 10000;
+  const size_t AREA_QUERIES = 10000;
+  const size_t AREA_BLASTS = 1000;
+  const size_t AREA_BUFFER = 4096;
+
+  // Circle (radius 0.2) and capsule (0.5 long, radius 0.05) queries over the collision snapshot
+  // of 10k enemies by backend, then area damage (radius 0.3); found is the mean enemy count
+  // per query
+  void benchAreaQueries()
+  {
+    Rng rng(1234);
+    std::vector<float> queryX(AREA_QUERIES), queryY(AREA_QUERIES), queryAngle(AREA_QUERIES);
+    rng.fillUniform(queryX.data(), AREA_QUERIES, -2.2f, 2.2f);
+    rng.fillUniform(queryY.data(), AREA_QUERIES, -2.2f, 2.2f);
+    rng.fillUniform(queryAngle.data(), AREA_QUERIES, -3.14159f, 3.14159f);
+    std::vector<EnemyHandle> found(AREA_BUFFER);
+
+    for (CollisionBackend backend : { CollisionBackend::Grid, CollisionBackend::SweepAndPrune, CollisionBackend::BruteForce })
+    {
+      Random::setGlobalSeed(1);
+      World world;
+      EnemyManager enemies(world);
+      enemies.setMaxEnemies((int)AREA_ENEMIES);
+      enemies.setSpawnRate(0.001f);
+      enemies.spawnBurst(AREA_ENEMIES, SpawnPattern::ScreenArea);
+      enemies.setCollisionBackend(backend);
+      GameSystems::movement(world, BOOKKEEPING_DELTA);
+      enemies.prepareCollision(BOOKKEEPING_DELTA);
+
+      size_t circleHits = 0, capsuleHits = 0;
+      auto start = Clock::now();
+      for (size_t q = 0; q < AREA_QUERIES; q++)
+        circleHits += enemies.queryCircle(queryX[q], queryY[q], 0.2f, found.data(), found.size());
+      double circleMs = millisecondsSince(start);
+
+      start = Clock::now();
+      for (size_t q = 0; q < AREA_QUERIES; q++)
+      {
+        float s, c;
+        FastMath::sinCos(queryAngle[q], s, c);
+        capsuleHits += enemies.queryCapsule(queryX[q], queryY[q], queryX[q] + 0.5f * c, queryY[q] + 0.5f * s, 0.05f,
+          found.data(), found.size());
+      }
+      double capsuleMs = millisecondsSince(start);
+
+      size_t before = enemies.getEnemyCount(), damaged = 0;
+      start = Clock::now();
+      for (size_t q = 0; q < AREA_BLASTS; q++)
+        damaged += enemies.damageArea(queryX[q], queryY[q], 0.3f, 3);
+      double blastMs = millisecondsSince(start);
+
+      std::cout << "  " << getCollisionBackendName(backend) << ": " << AREA_QUERIES << " circles " << circleMs
+        << " ms (found " << (double)circleHits / AREA_QUERIES << "), " << AREA_QUERIES << " capsules " << capsuleMs
+        << " ms (found " << (double)capsuleHits / AREA_QUERIES << "), " << AREA_BLASTS << " blasts " << blastMs
+        << " ms (" << damaged << " damaged, " << before - enemies.getEnemyCount() << " killed)" << std::endl;
+    }
+  }
+
+  const size_t RNG_DRAWS = 1 << 24;
+
+  // Throughput in millions of floats per second; the checksum keeps the draws alive
+  void reportRng(const char* name, double ms, double checksum)
+  {
+    std::cout << "  " << name << ": " << RNG_DRAWS / (ms * 1000.0) << " Mfloat/s (checksum " << checksum << ")" << std::endl;
+  }
+
+  // Uniform floats in [-1, 1) from each generator
+  void benchRng()
+  {
+    std::vector<float> buffer(RNG_DRAWS);
+
+    {
+      std::mt19937 gen(1234);
+      std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+      auto start = Clock::now();
+      for (float& value : buffer)
+        value = dis(gen);
+      reportRng("mt19937 + uniform_real_distribution", millisecondsSince(start), buffer[RNG_DRAWS / 2]);
+    }
+    {
+      Rng rng(1234);
+      auto start = Clock::now();
+      for (float& value : buffer)
+        value = rng.uniform(-1.0f, 1.0f);
+      reportRng("Rng::uniform", millisecondsSince(start), buffer[RNG_DRAWS / 2]);
+    }
+    {
+      Rng rng(1234);
+      auto start = Clock::now();
+      rng.fillUniform(buffer.data(), buffer.size(), -1.0f, 1.0f);
+      reportRng("Rng::fillUniform", millisecondsSince(start), buffer[RNG_DRAWS / 2]);
+    }
+    {
+      PhiloxStream philox(1234, 0);
+      auto start = Clock::now();
+      for (float& value : buffer)
+        value = philox.nextFloat() * 2.0f - 1.0f;
+      reportRng("PhiloxStream::nextFloat", millisecondsSince(start), buffer[RNG_DRAWS / 2]);
+    }
+  }
+
+  const size_t TRIG_VALUES = 1 << 22;
+
+  // Throughput in millions of values per second, and max error against double-precision libm
+  void reportTrig(const char* name, double ms, double maxError)
+  {
+    std::cout << "  " << name << ": " << TRIG_VALUES / (ms * 1000.0) << " M/s, max error " << maxError << std::endl;
+  }
+
+  // sin/cos of angles in [-100, 100] and atan2 of points in [-10, 10]^2, libm vs FastMath
+  void benchFastMath()
+  {
+    std::vector<float> angles(TRIG_VALUES), xs(TRIG_VALUES), ys(TRIG_VALUES);
+    Rng rng(1234);
+    rng.fillUniform(angles.data(), TRIG_VALUES, -100.0f, 100.0f);
+    rng.fillUniform(xs.data(), TRIG_VALUES, -10.0f, 10.0f);
+    rng.fillUniform(ys.data(), TRIG_VALUES, -10.0f, 10.0f);
+
+    std::vector<float> sines(TRIG_VALUES), cosines(TRIG_VALUES), out(TRIG_VALUES);
+    auto sinCosError = [&]() {
+      double maxError = 0.0;
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+      {
+        maxError = std::max(maxError, std::fabs(sines[i] - std::sin((double)angles[i])));
+        maxError = std::max(maxError, std::fabs(cosines[i] - std::cos((double)angles[i])));
+      }
+      return maxError;
+    };
+    auto atan2Error = [&]() {
+      double maxError = 0.0;
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+        maxError = std::max(maxError, std::fabs(out[i] - std::atan2((double)ys[i], (double)xs[i])));
+      return maxError;
+    };
+
+    {
+      auto start = Clock::now();
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+      {
+        sines[i] = std::sin(angles[i]);
+        cosines[i] = std::cos(angles[i]);
+      }
+      double ms = millisecondsSince(start);
+      reportTrig("std::sin + std::cos", ms, sinCosError());
+    }
+    {
+      auto start = Clock::now();
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+        FastMath::sinCos(angles[i], sines[i], cosines[i]);
+      double ms = millisecondsSince(start);
+      reportTrig("FastMath::sinCos (scalar)", ms, sinCosError());
+    }
+    {
+      auto start = Clock::now();
+      FastMath::sinCos(angles.data(), sines.data(), cosines.data(), TRIG_VALUES);
+      double ms = millisecondsSince(start);
+      reportTrig("FastMath::sinCos (batch)", ms, sinCosError());
+    }
+    {
+      auto start = Clock::now();
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+        out[i] = std::atan2(ys[i], xs[i]);
+      double ms = millisecondsSince(start);
+      reportTrig("std::atan2", ms, atan2Error());
+    }
+    {
+      auto start = Clock::now();
+      for (size_t i = 0; i < TRIG_VALUES; i++)
+        out[i] = FastMath::atan2(ys[i], xs[i]);
+      double ms = millisecondsSince(start);
+      reportTrig("FastMath::atan2 (scalar)", ms, atan2Error());
+    }
+    {
+      auto start = Clock::now();
+      FastMath::atan2(ys.data(), xs.data(), out.data(), TRIG_VALUES);
+      double ms = millisecondsSince(start);
+      reportTrig("FastMath::atan2 (batch)", ms, atan2Error());
+    }
+  }
+
+  struct Benchmark {
+    const char* name;
+    const char* description;
+    void (*run)();
+  };
+
+  const Benchmark BENCHMARKS[] = {
+    { "enemy_bookkeeping", "Enemy update at 100k enemies, full scan vs incremental vs entity world systems", benchEnemyBookkeeping },
+    { "spawn_burst", "10k enemy wave, one spawn call per enemy vs spawnBurst", benchSpawnBurst },
+    { "emitters", "Stress emitter frame cost, per-shot adds vs batched emission", benchEmitters },
+    { "swept_collision", "Hits and collision cost of a headless run at 240-4 Hz, point vs swept tests", benchSweptCollision },
+    { "broadphase", "5k enemies x 2k shots per frame, grid vs sweep and prune vs brute force", benchBroadphase },
+    { "flow_field", "100k enemies, straight-line movement vs flow field steering", benchFlowField },
+    { "crowd", "Crowd steering cost from 1k to 100k enemies, and how much it spreads them", benchCrowd },
+    { "overlap", "Enemy overlap solver at 10k and 50k enemies by Jacobi iteration budget", benchOverlap },
+    { "homing", "10k homing shots vs 50k enemies, k-d tree vs brute-force nearest-enemy lookups", benchHoming },
+    { "area_queries", "Circle and capsule range queries and area damage over 10k enemies, by collision backend", benchAreaQueries },
+    { "rng", "Uniform float throughput, mt19937 vs xoshiro (scalar and bulk) vs Philox", benchRng },
+    { "fast_math", "Trig throughput and accuracy, libm vs FastMath scalar and batch", benchFastMath },
+  };
+}
+
+int main(int argc, char** argv)
+{
+  const char* filter = argc > 1 ? argv[1] : "";
+
+  // Same spawns and sprays on every run
+  Random::setGlobalSeed(1);
+
+  for (const auto& benchmark : BENCHMARKS)
+  {
+    if (!strstr(benchmark.name, filter))
+      continue;
+
+    std::cout << benchmark.name << ": " << benchmark.description << std::endl;
+    benchmark.run();
+  }
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include "box_kernel.h"
+#include "transform_math.h"   // LLAMA_MATH_SSE
+
+#if LLAMA_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace BoxKernel
+{
+  uint32_t overlapMask(const BoxSpan& boxes, size_t first, float minX, float minY, float maxX, float maxY)
+  {
+    size_t count = boxes.count - first < BLOCK ? boxes.count - first : BLOCK;
+    uint32_t mask = 0;
+    size_t i = 0;
+#if LLAMA_MATH_SSE
+    __m128 queryMinX = _mm_set1_ps(minX), queryMinY = _mm_set1_ps(minY);
+    __m128 queryMaxX = _mm_set1_ps(maxX), queryMaxY = _mm_set1_ps(maxY);
+    for (; i + 4 <= count; i += 4)
+    {
+      size_t at = first + i;
+
+      // Separated when a box ends before the query starts or starts after it ends
+      __m128 apart = _mm_or_ps(_mm_cmplt_ps(_mm_loadu_ps(boxes.maxX + at), queryMinX),
+        _mm_cmpgt_ps(_mm_loadu_ps(boxes.minX + at), queryMaxX));
+      apart = _mm_or_ps(apart, _mm_cmplt_ps(_mm_loadu_ps(boxes.maxY + at), queryMinY));
+      apart = _mm_or_ps(apart, _mm_cmpgt_ps(_mm_loadu_ps(boxes.minY + at), queryMaxY));
+      mask |= (uint32_t)(~_mm_movemask_ps(apart) & 0xF) << i;
+    }
+#endif
+    for (; i < count; i++)
+    {
+      size_t at = first + i;
+      bool apart = boxes.maxX[at] < minX || boxes.minX[at] > maxX || boxes.maxY[at] < minY || boxes.minY[at] > maxY;
+      mask |= (uint32_t)!apart << i;
+    }
+    return mask;
+  }
+}
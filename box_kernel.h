@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A run of axis-aligned boxes in SoA form, as handed out by the broadphases: box i is
+// (minX[i], minY[i]) - (maxX[i], maxY[i]) and items[i] is the caller's index for it
+struct BoxSpan {
+  const float* minX;
+  const float* minY;
+  const float* maxX;
+  const float* maxY;
+  const uint32_t* items;
+  size_t count;
+};
+
+namespace BoxKernel
+{
+  // Boxes tested per overlapMask call (four 4-lane compares per edge under SSE2)
+  const size_t BLOCK = 16;
+
+  // Bit i is set when box first + i of the span overlaps the query box (touching counts), for
+  // the up to BLOCK boxes from first. A point query is a box with min == max. Bits come out in
+  // span order, so walking them low to high visits boxes in the order a scalar loop would.
+  uint32_t overlapMask(const BoxSpan& boxes, size_t first, float minX, float minY, float maxX, float maxY);
+}
@@ -1,25 +1,37 @@
 #include "camera.h"
 #include <cmath>
 
-Camera::Camera() : zoomLevel(2.0f) // Start with 2x zoom out for better field of view
+#include <cstring>
+
+Camera::Camera() : zoomLevel(2.0f), version(0), viewDirty(true) // Start with 2x zoom out for better field of view
+{
+}
+
+void Camera::setZoom(float zoom)
+{
+  if (zoom == zoomLevel)
+    return;
+
+  zoomLevel = zoom;
+  viewDirty = true;
+  version++;
+}
+
+const Mat4& Camera::getViewProjection() const
 {
+  if (viewDirty)
+  {
+    // Higher zoom = smaller objects = can see more area
+    float scale = 1.0f / zoomLevel;
+    viewProjection = Mat4::scale(scale, scale);
+    viewDirty = false;
+  }
+  return viewProjection;
 }
 
 void Camera::createViewMatrix(float matrix[16]) const
 {
-  // Create a scaling matrix that zooms out the view
-  // Higher zoom = smaller objects = can see more area
-  float scale = 1.0f / zoomLevel;
-
-  // Initialize to identity matrix
-  for (int i = 0; i < 16; i++)
-    matrix[i] = 0.0f;
-
-  // Set scaling matrix
-  matrix[0] = scale;   // X scale
-  matrix[5] = scale;   // Y scale  
-  matrix[10] = 1.0f;   // Z scale (unchanged)
-  matrix[15] = 1.0f;   // W component
+  memcpy(matrix, getViewProjection().data(), sizeof(float) * 16);
 }
 
 void Camera::screenToWorld(float screenX, float screenY, int windowWidth, int windowHeight, float& worldX, float& worldY) const
@@ -1,15 +1,23 @@
 #pragma once
 
+#include "transform_math.h"
+
 class Camera
 {
 public:
   Camera();
 
   // Set the zoom level (higher = more zoomed out, can see more)
-  void setZoom(float zoom) { zoomLevel = zoom; }
+  void setZoom(float zoom);
   float getZoom() const { return zoomLevel; }
 
-  // Create view matrix that can be applied to all objects
+  // View-projection applied to all objects; rebuilt only after the camera changes
+  const Mat4& getViewProjection() const;
+
+  // Bumped on every change, so callers can re-upload uniforms only when it moves
+  unsigned int getVersion() const { return version; }
+
+  // Copy the view matrix into a plain array
   void createViewMatrix(float matrix[16]) const;
 
   // Convert screen coordinates to world coordinates
@@ -17,4 +25,9 @@ public:
 
 private:
   float zoomLevel; // 1.0 = normal, 2.0 = see twice as much area
+  unsigned int version;
+
+  // Cached view-projection
+  mutable Mat4 viewProjection;
+  mutable bool viewDirty;
 };
\ No newline at end of file
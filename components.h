@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ecs.h"
+
+// Components shared by the game's entity kinds. Each is plain data stored in its own
+// array per chunk (see ecs.h); behaviour lives in systems (game_systems.h) and managers.
+
+struct Position {
+  float x, y;
+};
+
+struct Velocity {
+  float x, y;
+};
+
+struct Rotation {
+  float angle;   // Radians
+};
+
+// Time alive, in seconds
+struct Age {
+  float seconds;
+};
+
+// Frame = age * framesPerSecond, cycling through frameCount frames
+struct SpriteAnimation {
+  float framesPerSecond;
+  int frameCount;
+  int frame;
+};
+
+struct Health {
+  int hitPoints;
+};
+
+// Reappear on the opposite edge when leaving the [-extent, extent] square
+struct ScreenWrap {
+  float extent;
+};
+
+// Destroyed once older than maxAge or outside the [-extent, extent] square
+struct Expiry {
+  float maxAge;
+  float extent;
+};
+
+// Turns Velocity toward the enemy flow field's heading at speed; turnRate is the fraction of
+// the difference closed per second
+struct FlowSteering {
+  float speed;
+  float turnRate;
+};
+
+// Turns Velocity toward target at up to turnRate radians per second, keeping its speed.
+// Every retargetInterval seconds (and whenever the target dies) target becomes the nearest
+// live enemy; a null target flies straight.
+struct Homing {
+  float turnRate;
+  float retargetInterval;
+  float retargetTimer;   // Seconds until the next retarget
+  Entity target;
+};
+
+// Explodes where it hits an enemy, damaging every enemy within radius: damage hit points at
+// the centre, falling off linearly with distance to the enemy's box
+struct Explosive {
+  float radius;
+  int damage;
+};
+
+// Kind markers, which also carry the per-kind collision size
+
+struct EnemyBody {
+  float size;    // Size multiplier (the base quad is 0.3 wide)
+};
+
+struct ProjectileBody {
+  float radius;
+};
+
+struct LlamaTag {
+};
@@ -0,0 +1,383 @@
+#include "crowd.h"
+#include "profiler.h"
+#include "transform_math.h"   // LLAMA_MATH_SSE
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if LLAMA_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+  // Grid cells per parallelFor block
+  const size_t CELL_BLOCK_SIZE = 16;
+
+  // Closest distance the separation push grows to, as a fraction of the radius, so agents on
+  // top of each other get a finite push
+  const float MIN_DISTANCE = 0.05f;
+
+  // Rows of the 3x3 block around an agent's cell, own row first
+  const int ROW_ORDER[3] = { 0, -1, 1 };
+
+  // Gathered neighbours, with room to pad the last register
+  struct Neighbours {
+    alignas(16) float x[Crowd::MAX_NEIGHBOURS + 3];
+    alignas(16) float y[Crowd::MAX_NEIGHBOURS + 3];
+    alignas(16) float velX[Crowd::MAX_NEIGHBOURS + 3];
+    alignas(16) float velY[Crowd::MAX_NEIGHBOURS + 3];
+  };
+
+  // Sums over the neighbours within the radius: the separation push, the offsets from the
+  // agent (toward their centroid) and their velocities
+  struct Pushes {
+    float separationX, separationY;
+    float offsetX, offsetY;
+    float velX, velY;
+    float count;
+  };
+
+#if LLAMA_MATH_SSE
+  float horizontalSum(__m128 v)
+  {
+    __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+  }
+#else
+  // horizontalSum's order over four scalar lanes
+  float laneSum(const float lanes[4])
+  {
+    return (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+  }
+#endif
+
+  // count is padded up to a multiple of four with agents outside the radius
+  Pushes accumulate(const Neighbours& near, int count, float x, float y, float radius)
+  {
+    float radiusSquared = radius * radius;
+    float minSquared = radiusSquared * MIN_DISTANCE * MIN_DISTANCE;
+    Pushes sums;
+#if LLAMA_MATH_SSE
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y);
+    const __m128 outer = _mm_set1_ps(radiusSquared), inner = _mm_set1_ps(minSquared);
+    const __m128 inverseOuter = _mm_set1_ps(1.0f / radiusSquared);
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 separationX = _mm_setzero_ps(), separationY = _mm_setzero_ps();
+    __m128 offsetX = _mm_setzero_ps(), offsetY = _mm_setzero_ps();
+    __m128 velX = _mm_setzero_ps(), velY = _mm_setzero_ps();
+    __m128 within = _mm_setzero_ps();
+    for (int k = 0; k < count; k += 4)
+    {
+      __m128 dx = _mm_sub_ps(px, _mm_load_ps(near.x + k));
+      __m128 dy = _mm_sub_ps(py, _mm_load_ps(near.y + k));
+      __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      __m128 inside = _mm_cmplt_ps(distanceSquared, outer);
+
+      // 1/d^2 - 1/r^2 along the offset: about 1/d up close, fading to 0 at the radius
+      __m128 weight = _mm_and_ps(inside, _mm_sub_ps(_mm_div_ps(one, _mm_max_ps(distanceSquared, inner)), inverseOuter));
+      separationX = _mm_add_ps(separationX, _mm_mul_ps(dx, weight));
+      separationY = _mm_add_ps(separationY, _mm_mul_ps(dy, weight));
+      offsetX = _mm_sub_ps(offsetX, _mm_and_ps(inside, dx));
+      offsetY = _mm_sub_ps(offsetY, _mm_and_ps(inside, dy));
+      velX = _mm_add_ps(velX, _mm_and_ps(inside, _mm_load_ps(near.velX + k)));
+      velY = _mm_add_ps(velY, _mm_and_ps(inside, _mm_load_ps(near.velY + k)));
+      within = _mm_add_ps(within, _mm_and_ps(inside, one));
+    }
+    sums.separationX = horizontalSum(separationX);
+    sums.separationY = horizontalSum(separationY);
+    sums.offsetX = horizontalSum(offsetX);
+    sums.offsetY = horizontalSum(offsetY);
+    sums.velX = horizontalSum(velX);
+    sums.velY = horizontalSum(velY);
+    sums.count = horizontalSum(within);
+#else
+    // Four lane sums combined as horizontalSum does, so both builds round the same way
+    float separationX[4] = {}, separationY[4] = {}, offsetX[4] = {}, offsetY[4] = {};
+    float velX[4] = {}, velY[4] = {}, within[4] = {};
+    for (int k = 0; k < count; k++)
+    {
+      int lane = k & 3;
+      float dx = x - near.x[k], dy = y - near.y[k];
+      float distanceSquared = dx * dx + dy * dy;
+      if (!(distanceSquared < radiusSquared))
+        continue;
+      float weight = 1.0f / std::max(distanceSquared, minSquared) - 1.0f / radiusSquared;
+      separationX[lane] += dx * weight;
+      separationY[lane] += dy * weight;
+      offsetX[lane] -= dx;
+      offsetY[lane] -= dy;
+      velX[lane] += near.velX[k];
+      velY[lane] += near.velY[k];
+      within[lane] += 1.0f;
+    }
+    sums.separationX = laneSum(separationX);
+    sums.separationY = laneSum(separationY);
+    sums.offsetX = laneSum(offsetX);
+    sums.offsetY = laneSum(offsetY);
+    sums.velX = laneSum(velX);
+    sums.velY = laneSum(velY);
+    sums.count = laneSum(within);
+#endif
+    return sums;
+  }
+
+  // Pushes out of an agent's contacts so far, each the full overlap along its smaller axis,
+  // counted per axis so pushes along one axis are averaged among themselves
+  struct Contacts {
+    float shiftX, shiftY;
+    int countX, countY;
+  };
+
+  // Adds the contacts of entry self among entries [first, last), stopping once there are
+  // limit. Entries go four at a time with the limit checked after each four; the SSE path
+  // masks off the ones past last (so the columns must be readable three entries further).
+  void collectContacts(const float* xs, const float* ys, const float* halves, uint32_t self, uint32_t first, uint32_t last,
+    int limit, Contacts& contacts)
+  {
+    float x = xs[self], y = ys[self], half = halves[self];
+    uint32_t j = first;
+#if LLAMA_MATH_SSE
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y), ph = _mm_set1_ps(half);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i selfIndex = _mm_set1_epi32((int)self);
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i lastIndex = _mm_set1_epi32((int)last);
+    __m128 shiftX = _mm_setzero_ps(), shiftY = _mm_setzero_ps();
+    for (; j < last && contacts.countX + contacts.countY < limit; j += 4)
+    {
+      __m128 offsetX = _mm_sub_ps(px, _mm_loadu_ps(xs + j));
+      __m128 offsetY = _mm_sub_ps(py, _mm_loadu_ps(ys + j));
+      __m128 reach = _mm_add_ps(ph, _mm_loadu_ps(halves + j));
+      __m128 overlapX = _mm_sub_ps(reach, _mm_andnot_ps(signBit, offsetX));
+      __m128 overlapY = _mm_sub_ps(reach, _mm_andnot_ps(signBit, offsetY));
+
+      __m128i index = _mm_add_epi32(_mm_set1_epi32((int)j), lanes);
+      __m128 touching = _mm_and_ps(_mm_cmpgt_ps(overlapX, zero), _mm_cmpgt_ps(overlapY, zero));
+      touching = _mm_andnot_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(index, selfIndex)), touching);
+      touching = _mm_and_ps(_mm_castsi128_ps(_mm_cmplt_epi32(index, lastIndex)), touching);
+      if (!_mm_movemask_ps(touching))
+        continue;
+
+      // Away from the other square; boxes exactly in line go the way their entry order says
+      __m128 tieNegative = _mm_castsi128_ps(_mm_cmplt_epi32(selfIndex, index));
+      __m128 negativeX = _mm_or_ps(_mm_cmplt_ps(offsetX, zero), _mm_andnot_ps(_mm_cmpgt_ps(offsetX, zero), tieNegative));
+      __m128 negativeY = _mm_or_ps(_mm_cmplt_ps(offsetY, zero), _mm_andnot_ps(_mm_cmpgt_ps(offsetY, zero), tieNegative));
+      __m128 signX = _mm_or_ps(_mm_and_ps(negativeX, minusOne), _mm_andnot_ps(negativeX, one));
+      __m128 signY = _mm_or_ps(_mm_and_ps(negativeY, minusOne), _mm_andnot_ps(negativeY, one));
+
+      __m128 alongX = _mm_cmplt_ps(overlapX, overlapY);
+      __m128 pushX = _mm_and_ps(touching, alongX), pushY = _mm_andnot_ps(alongX, touching);
+      shiftX = _mm_add_ps(shiftX, _mm_and_ps(pushX, _mm_mul_ps(signX, overlapX)));
+      shiftY = _mm_add_ps(shiftY, _mm_and_ps(pushY, _mm_mul_ps(signY, overlapY)));
+      contacts.countX += std::popcount((unsigned int)_mm_movemask_ps(pushX));
+      contacts.countY += std::popcount((unsigned int)_mm_movemask_ps(pushY));
+    }
+    contacts.shiftX += horizontalSum(shiftX);
+    contacts.shiftY += horizontalSum(shiftY);
+#else
+    // Same blocking as the SSE path: four entries at a time, the limit checked between blocks
+    // and the pushes kept in four lane sums
+    float shiftX[4] = {}, shiftY[4] = {};
+    for (; j < last && contacts.countX + contacts.countY < limit; j += 4)
+    {
+      for (uint32_t lane = 0; lane < 4 && j + lane < last; lane++)
+      {
+        uint32_t k = j + lane;
+        float offsetX = x - xs[k], offsetY = y - ys[k];
+        float reach = half + halves[k];
+        float overlapX = reach - std::fabs(offsetX), overlapY = reach - std::fabs(offsetY);
+        if (k == self || !(overlapX > 0.0f && overlapY > 0.0f))
+          continue;
+
+        float tie = self < k ? -1.0f : 1.0f;
+        if (overlapX < overlapY)
+        {
+          shiftX[lane] += (offsetX > 0.0f ? 1.0f : offsetX < 0.0f ? -1.0f : tie) * overlapX;
+          contacts.countX++;
+        }
+        else
+        {
+          shiftY[lane] += (offsetY > 0.0f ? 1.0f : offsetY < 0.0f ? -1.0f : tie) * overlapY;
+          contacts.countY++;
+        }
+      }
+    }
+    contacts.shiftX += laneSum(shiftX);
+    contacts.shiftY += laneSum(shiftY);
+#endif
+  }
+}
+
+Crowd::Crowd(JobPool& jobs)
+  : jobs(jobs)
+{
+}
+
+void Crowd::steer(const float* x, const float* y, const float* velX, const float* velY, size_t count, float deltaTime,
+  float* outVelX, float* outVelY)
+{
+  PROFILE_ZONE("Crowd steering");
+  if (count == 0)
+    return;
+
+  // Cells one radius wide, so the 3x3 cells around an agent cover its neighbourhood
+  const float radius = weights.radius;
+  grid.setCellSize(radius);
+  grid.build(x, y, x, y, count);
+
+  const CrowdWeights w = weights;
+  const int limit = std::min(std::max(w.maxNeighbours, 0), MAX_NEIGHBOURS);
+  jobs.parallelFor(grid.getCellCount(), CELL_BLOCK_SIZE, [&](size_t firstCell, size_t lastCell) {
+    Neighbours near;
+    for (size_t c = firstCell; c < lastCell; c++)
+    {
+      // Agents a cell at a time, so neighbouring agents share the cells they read
+      BoxSpan agents = grid.getCell(c);
+      for (size_t a = 0; a < agents.count; a++)
+      {
+        uint32_t i = agents.items[a];
+        float px = agents.minX[a], py = agents.minY[a];
+
+        // Own cell first, so a full neighbour list favours the closest agents
+        int found = 0;
+        if (limit > 0)
+        {
+          grid.queryNeighbours(px, py, [&](const BoxSpan& cell) {
+            for (size_t first = 0; first < cell.count; first += BoxKernel::BLOCK)
+            {
+              uint32_t mask = BoxKernel::overlapMask(cell, first, px - radius, py - radius, px + radius, py + radius);
+              for (; mask; mask &= mask - 1)
+              {
+                size_t k = first + std::countr_zero(mask);
+                uint32_t item = cell.items[k];
+                if (item == i)
+                  continue;
+                near.x[found] = cell.minX[k];
+                near.y[found] = cell.minY[k];
+                near.velX[found] = velX[item];
+                near.velY[found] = velY[item];
+                if (++found == limit)
+                  return false;
+              }
+            }
+            return true;
+          });
+        }
+
+        int padded = (found + 3) & ~3;
+        for (int k = found; k < padded; k++)
+        {
+          near.x[k] = px + 2.0f * radius;
+          near.y[k] = py;
+          near.velX[k] = 0.0f;
+          near.velY[k] = 0.0f;
+        }
+
+        Pushes sums = accumulate(near, padded, px, py, radius);
+        float accelX = w.separation * sums.separationX;
+        float accelY = w.separation * sums.separationY;
+        if (sums.count > 0.0f)
+        {
+          float inverseCount = 1.0f / sums.count;
+          accelX += w.alignment * (sums.velX * inverseCount - velX[i]) + w.cohesion * sums.offsetX * inverseCount;
+          accelY += w.alignment * (sums.velY * inverseCount - velY[i]) + w.cohesion * sums.offsetY * inverseCount;
+        }
+
+        float lengthSquared = accelX * accelX + accelY * accelY;
+        if (lengthSquared > w.maxAcceleration * w.maxAcceleration)
+        {
+          float scale = w.maxAcceleration / std::sqrt(lengthSquared);
+          accelX *= scale;
+          accelY *= scale;
+        }
+        outVelX[i] = velX[i] + accelX * deltaTime;
+        outVelY[i] = velY[i] + accelY * deltaTime;
+      }
+    }
+  });
+}
+
+void Crowd::resolveOverlaps(float* x, float* y, const float* halfSize, size_t count)
+{
+  PROFILE_ZONE("Crowd overlaps");
+  const OverlapSettings settings = overlap;
+  if (count < 2 || settings.iterations <= 0 || settings.maxContacts <= 0)
+    return;
+
+  float largest = 0.0f;
+  for (size_t i = 0; i < count; i++)
+    largest = std::max(largest, halfSize[i]);
+  if (largest <= 0.0f)
+    return;
+
+  // Agents stay in their cell's list all call, moving at most maxShift; cells that wide keep
+  // every pair that can touch within neighbouring cells
+  const float maxShift = settings.maxShift * largest;
+  grid.setCellSize(2.0f * largest + 2.0f * maxShift);
+  grid.build(x, y, x, y, count);
+
+  // Three entries of padding for the contact scan's last register
+  const uint32_t* items = grid.getItems();
+  solverX.assign(count + 3, 0.0f);
+  solverY.assign(count + 3, 0.0f);
+  nextX.assign(count + 3, 0.0f);
+  nextY.assign(count + 3, 0.0f);
+  startX.resize(count);
+  startY.resize(count);
+  solverHalf.assign(count + 3, 0.0f);
+  for (size_t e = 0; e < count; e++)
+  {
+    uint32_t item = items[e];
+    startX[e] = solverX[e] = x[item];
+    startY[e] = solverY[e] = y[item];
+    solverHalf[e] = halfSize[item];
+  }
+
+  const int columns = grid.getColumns(), rows = grid.getRows();
+  const float scale = 0.5f * settings.relaxation;
+  for (int iteration = 0; iteration < settings.iterations; iteration++)
+  {
+    jobs.parallelFor(grid.getCellCount(), CELL_BLOCK_SIZE, [&](size_t firstCell, size_t lastCell) {
+      for (size_t c = firstCell; c < lastCell; c++)
+      {
+        int column = (int)(c % columns), row = (int)(c / columns);
+        int firstColumn = std::max(column - 1, 0), lastColumn = std::min(column + 1, columns - 1);
+        for (uint32_t e = grid.getCellBegin(c), end = grid.getCellBegin(c + 1); e < end; e++)
+        {
+          // The three cells of a row are next to each other in the grid, so the 3x3 block
+          // around the agent is three runs of entries: its own row first
+          Contacts contacts{ 0.0f, 0.0f, 0, 0 };
+          for (int k = 0; k < 3 && contacts.countX + contacts.countY < settings.maxContacts; k++)
+          {
+            int toRow = row + ROW_ORDER[k];
+            if (toRow < 0 || toRow >= rows)
+              continue;
+            size_t rowStart = (size_t)toRow * columns;
+            collectContacts(solverX.data(), solverY.data(), solverHalf.data(), e, grid.getCellBegin(rowStart + firstColumn),
+              grid.getCellBegin(rowStart + lastColumn + 1), settings.maxContacts, contacts);
+          }
+
+          // Each pair splits its overlap, so half the averaged push
+          float newX = solverX[e], newY = solverY[e];
+          if (contacts.countX > 0)
+            newX = std::min(std::max(newX + contacts.shiftX * scale / contacts.countX, startX[e] - maxShift), startX[e] + maxShift);
+          if (contacts.countY > 0)
+            newY = std::min(std::max(newY + contacts.shiftY * scale / contacts.countY, startY[e] - maxShift), startY[e] + maxShift);
+          nextX[e] = newX;
+          nextY[e] = newY;
+        }
+      }
+    });
+    solverX.swap(nextX);
+    solverY.swap(nextY);
+  }
+
+  for (size_t e = 0; e < count; e++)
+  {
+    x[items[e]] = solverX[e];
+    y[items[e]] = solverY[e];
+  }
+}
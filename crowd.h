@@ -0,0 +1,71 @@
+#pragma once
+
+#include "job_pool.h"
+#include "spatial_grid.h"
+
+#include <cstddef>
+#include <vector>
+
+// Local avoidance weights. Accelerations are in units per second squared.
+struct CrowdWeights {
+  float radius = 0.3f;             // Neighbourhood radius (about one enemy width)
+  float separation = 0.2f;         // Push away from each neighbour, growing as 1 / distance
+  float alignment = 0.5f;          // Pull toward the neighbours' mean velocity, per second
+  float cohesion = 0.2f;           // Pull toward the neighbours' centroid, per second squared
+  float maxAcceleration = 2.0f;    // Cap on the summed push
+  int maxNeighbours = 16;          // At most Crowd::MAX_NEIGHBOURS
+};
+
+// Overlap solver settings; half sizes are the ones passed to Crowd::resolveOverlaps
+struct OverlapSettings {
+  int iterations = 4;          // Jacobi iterations per frame
+  float relaxation = 1.5f;     // Scales each iteration's averaged push: 1 exactly separates a lone pair,
+                               // more converges faster in packed crowds (up to 2)
+  float maxShift = 0.5f;       // Furthest an agent moves per frame, in largest half sizes
+  int maxContacts = 16;        // Contacts averaged per agent per iteration
+};
+
+// Interactions between nearby agents, each pass gridding the agents by position and walking
+// them cell by cell in blocks on the caller's JobPool. Every block only reads the pass's inputs
+// and writes its own agents' outputs, so results do not depend on the thread count.
+//
+// steer: separation, alignment and cohesion. Each agent takes up to maxNeighbours agents from
+// its own cell and then the cells around it (the bound keeps dense crowds from costing more
+// per agent), sums their pushes four neighbours at a time and caps the total.
+//
+// resolveOverlaps: position-based pushes between overlapping squares. Each Jacobi iteration
+// computes every agent's new position from the previous iteration's positions: the average
+// of the pushes out of its contacts (each pair splits the overlap, along the axis where it is
+// smaller). The grid is built once per call with cells wide enough for any pair that can
+// touch within the per-frame shift cap, and positions are kept in the grid's order so the
+// contact scan reads contiguous memory.
+class Crowd
+{
+public:
+  static constexpr int MAX_NEIGHBOURS = 32;
+
+  explicit Crowd(JobPool& jobs);
+
+  void setWeights(const CrowdWeights& newWeights) { weights = newWeights; }
+  const CrowdWeights& getWeights() const { return weights; }
+
+  // New velocities after deltaTime of avoidance, for count agents given as SoA columns;
+  // the outputs must not alias the inputs
+  void steer(const float* x, const float* y, const float* velX, const float* velY, size_t count, float deltaTime,
+    float* outVelX, float* outVelY);
+
+  void setOverlapSettings(const OverlapSettings& settings) { overlap = settings; }
+  const OverlapSettings& getOverlapSettings() const { return overlap; }
+
+  // Push overlapping agents apart in place: squares centred on (x, y) with the given half sizes
+  void resolveOverlaps(float* x, float* y, const float* halfSize, size_t count);
+
+private:
+  CrowdWeights weights;
+  OverlapSettings overlap;
+  JobPool& jobs;
+  SpatialGrid grid;   // Rebuilt by each pass
+
+  // Overlap solver columns in the grid's entry order; next is the iteration being written
+  std::vector<float> solverX, solverY, nextX, nextY, startX, startY, solverHalf;
+};
@@ -0,0 +1,269 @@
+#include "ecs.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace EcsDetail
+{
+  static std::vector<ComponentInfo>& registry()
+  {
+    static std::vector<ComponentInfo> infos;
+    return infos;
+  }
+
+  ComponentId registerComponent(size_t size, size_t alignment)
+  {
+    std::vector<ComponentInfo>& infos = registry();
+    if (infos.size() >= MAX_COMPONENT_TYPES)
+    {
+      std::cout << "ERROR::ECS::TOO_MANY_COMPONENT_TYPES (max " << MAX_COMPONENT_TYPES << ")" << std::endl;
+      std::abort();
+    }
+    infos.push_back(ComponentInfo{ size, alignment });
+    return (ComponentId)(infos.size() - 1);
+  }
+
+  const ComponentInfo& componentInfo(ComponentId id)
+  {
+    return registry()[id];
+  }
+}
+
+namespace
+{
+  // Columns start on 16 bytes so SIMD loops can use aligned loads
+  const size_t COLUMN_ALIGNMENT = 16;
+
+  size_t alignUp(size_t value, size_t alignment)
+  {
+    return (value + alignment - 1) & ~(alignment - 1);
+  }
+}
+
+Archetype::Archetype(ComponentMask mask) : mask(mask), columnOffset{}, capacity(0), entityCount(0)
+{
+  size_t rowBytes = sizeof(Entity);
+  for (ComponentId id = 0; id < MAX_COMPONENT_TYPES; id++)
+  {
+    if (has(id))
+    {
+      components.push_back(id);
+      rowBytes += EcsDetail::componentInfo(id).size;
+    }
+  }
+
+  // Leave room for the padding in front of every column
+  size_t padding = COLUMN_ALIGNMENT * (components.size() + 1);
+  capacity = (uint32_t)std::max<size_t>(1, (CHUNK_BYTES - padding) / rowBytes);
+
+  size_t offset = alignUp(sizeof(Entity) * capacity, COLUMN_ALIGNMENT);
+  for (ComponentId id : components)
+  {
+    const EcsDetail::ComponentInfo& info = EcsDetail::componentInfo(id);
+    offset = alignUp(offset, std::max(info.alignment, COLUMN_ALIGNMENT));
+    columnOffset[id] = (uint32_t)offset;
+    offset += info.size * capacity;
+  }
+}
+
+void Archetype::pushRow(uint32_t& chunk, uint32_t& row)
+{
+  if (chunks.empty() || chunks.back().count == capacity)
+  {
+    Chunk fresh;
+    // operator new[] returns memory aligned for any fundamental type (16 bytes on x86-64)
+    fresh.memory = spareChunk ? std::move(spareChunk) : std::unique_ptr<unsigned char[]>(new unsigned char[CHUNK_BYTES]);
+    chunks.push_back(std::move(fresh));
+  }
+
+  chunk = (uint32_t)(chunks.size() - 1);
+  row = chunks.back().count++;
+  entityCount++;
+}
+
+uint32_t Archetype::pushRows(size_t maxRows, uint32_t& chunk, uint32_t& firstRow)
+{
+  if (chunks.empty() || chunks.back().count == capacity)
+    pushRow(chunk, firstRow);   // Opens a chunk and takes its first row
+  else
+  {
+    chunk = (uint32_t)(chunks.size() - 1);
+    firstRow = chunks.back().count++;
+    entityCount++;
+  }
+
+  uint32_t extra = (uint32_t)std::min<size_t>(maxRows - 1, capacity - chunks.back().count);
+  chunks.back().count += extra;
+  entityCount += extra;
+  return extra + 1;
+}
+
+void Archetype::popRow()
+{
+  entityCount--;
+  if (--chunks.back().count == 0)
+  {
+    // Keep one block around so spawning and despawning across a chunk boundary doesn't thrash
+    spareChunk = std::move(chunks.back().memory);
+    chunks.pop_back();
+  }
+}
+
+bool World::destroy(Entity entity)
+{
+  EntityLocation* location = entities.get(entity);
+  if (!location)
+    return false;
+
+  removeRow(*location->archetype, location->chunk, location->row);
+  entities.remove(entity);
+  return true;
+}
+
+void World::flushDestroyed()
+{
+  // Stale or repeated handles are ignored by destroy
+  for (Entity entity : pendingDestroy)
+    destroy(entity);
+  pendingDestroy.clear();
+}
+
+void World::clear()
+{
+  for (auto& archetype : archetypes)
+  {
+    archetype->chunks.clear();
+    archetype->entityCount = 0;
+  }
+  entities.clear();
+  pendingDestroy.clear();
+}
+
+Archetype* World::findOrCreateArchetype(ComponentMask mask)
+{
+  auto found = archetypeByMask.find(mask);
+  if (found != archetypeByMask.end())
+    return found->second;
+
+  archetypes.push_back(std::make_unique<Archetype>(mask));
+  Archetype* archetype = archetypes.back().get();
+  archetypeByMask[mask] = archetype;
+  return archetype;
+}
+
+Entity World::allocate(ComponentMask mask)
+{
+  Archetype* archetype = findOrCreateArchetype(mask);
+  EntityLocation location{ archetype, 0, 0 };
+  archetype->pushRow(location.chunk, location.row);
+
+  Entity entity = entities.insert(location);
+  archetype->entities(location.chunk)[location.row] = entity;
+  return entity;
+}
+
+Archetype* World::beginBatch(ComponentMask mask, size_t count)
+{
+  Archetype* archetype = findOrCreateArchetype(mask);
+  entities.reserve(entities.size() + count);
+  archetype->chunks.reserve(archetype->chunks.size() + count / archetype->capacity + 1);
+  return archetype;
+}
+
+uint32_t World::allocateRun(Archetype& archetype, size_t maxRows, uint32_t& chunk, uint32_t& firstRow)
+{
+  uint32_t rows = archetype.pushRows(maxRows, chunk, firstRow);
+  Entity* handles = archetype.entities(chunk);
+  for (uint32_t i = 0; i < rows; i++)
+    handles[firstRow + i] = entities.insert(EntityLocation{ &archetype, chunk, firstRow + i });
+  return rows;
+}
+
+void World::removeRow(Archetype& archetype, uint32_t chunk, uint32_t row)
+{
+  uint32_t lastChunk = (uint32_t)(archetype.chunks.size() - 1);
+  uint32_t lastRow = archetype.chunks[lastChunk].count - 1;
+
+  if (chunk != lastChunk || row != lastRow)
+  {
+    // Move the last entity into the gap to keep chunks dense
+    Entity moved = archetype.entities(lastChunk)[lastRow];
+    archetype.entities(chunk)[row] = moved;
+    for (ComponentId id : archetype.components)
+    {
+      size_t size = EcsDetail::componentInfo(id).size;
+      std::memcpy(static_cast<unsigned char*>(archetype.column(chunk, id)) + row * size,
+        static_cast<unsigned char*>(archetype.column(lastChunk, id)) + lastRow * size, size);
+    }
+
+    EntityLocation* movedLocation = entities.get(moved);
+    movedLocation->chunk = chunk;
+    movedLocation->row = row;
+  }
+
+  archetype.popRow();
+}
+
+void World::moveToArchetype(Entity entity, ComponentMask mask)
+{
+  EntityLocation* location = entities.get(entity);
+  Archetype& source = *location->archetype;
+  Archetype* target = findOrCreateArchetype(mask);
+  if (target == &source)
+    return;
+
+  uint32_t chunk, row;
+  target->pushRow(chunk, row);
+  target->entities(chunk)[row] = entity;
+
+  // Components the entity keeps; an added one is written by the caller
+  for (ComponentId id : target->components)
+  {
+    if (!source.has(id))
+      continue;
+    size_t size = EcsDetail::componentInfo(id).size;
+    std::memcpy(static_cast<unsigned char*>(target->column(chunk, id)) + row * size,
+      static_cast<unsigned char*>(source.column(location->chunk, id)) + location->row * size, size);
+  }
+
+  // Only rows move here, never entity records, so location stays valid
+  removeRow(source, location->chunk, location->row);
+  location->archetype = target;
+  location->chunk = chunk;
+  location->row = row;
+}
+
+void World::destroyMatching(ComponentMask query)
+{
+  for (auto& archetype : archetypes)
+  {
+    if ((archetype->getMask() & query) != query)
+      continue;
+
+    for (size_t c = 0; c < archetype->chunks.size(); c++)
+    {
+      const Entity* handles = archetype->entities(c);
+      for (uint32_t i = 0; i < archetype->chunks[c].count; i++)
+        entities.remove(handles[i]);
+    }
+    archetype->chunks.clear();
+    archetype->entityCount = 0;
+  }
+}
+
+void SystemScheduler::add(const char* name, System system)
+{
+  systems.push_back(Entry{ name, std::move(system) });
+}
+
+void SystemScheduler::run(World& world, float deltaTime)
+{
+  for (Entry& system : systems)
+  {
+    PROFILE_ZONE(system.name);
+    system.run(world, deltaTime);
+    world.flushDestroyed();
+  }
+}
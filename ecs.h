@@ -0,0 +1,324 @@
+#pragma once
+
+#include "slot_map.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Archetype-based entity-component store.
+//
+// Entities with the same set of component types share an archetype. An archetype keeps its
+// entities in fixed-size chunks, and inside a chunk each component type is one contiguous
+// array (SoA), so a system touching Position and Velocity streams exactly those two arrays.
+// Components are plain data; they are moved between rows with memcpy.
+
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t;
+const ComponentId MAX_COMPONENT_TYPES = 64;
+
+class Archetype;
+
+// Where an entity's row lives
+struct EntityLocation {
+  Archetype* archetype;
+  uint32_t chunk;
+  uint32_t row;
+};
+
+// Generational entity handle: goes stale when the entity is destroyed
+using Entity = SlotHandle<EntityLocation>;
+
+namespace EcsDetail
+{
+  struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+  };
+
+  ComponentId registerComponent(size_t size, size_t alignment);
+  const ComponentInfo& componentInfo(ComponentId id);
+}
+
+// Ids are handed out on first use, so any trivially copyable struct can be a component
+template <typename T>
+ComponentId componentId()
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable");
+  static const ComponentId id = EcsDetail::registerComponent(sizeof(T), alignof(T));
+  return id;
+}
+
+template <typename... Ts>
+ComponentMask componentMask()
+{
+  return (ComponentMask(0) | ... | (ComponentMask(1) << componentId<Ts>()));
+}
+
+class Archetype
+{
+public:
+  static const size_t CHUNK_BYTES = 16 * 1024;
+
+  explicit Archetype(ComponentMask mask);
+
+  ComponentMask getMask() const { return mask; }
+  bool has(ComponentId id) const { return (mask >> id) & 1; }
+
+  // Entities stored, and how many fit in one chunk
+  size_t size() const { return entityCount; }
+  uint32_t getChunkCapacity() const { return capacity; }
+
+  size_t getChunkCount() const { return chunks.size(); }
+  uint32_t getChunkSize(size_t chunk) const { return chunks[chunk].count; }
+
+  // Column base pointers; columns start 16-byte aligned
+  Entity* entities(size_t chunk) const { return reinterpret_cast<Entity*>(chunks[chunk].memory.get()); }
+  void* column(size_t chunk, ComponentId id) const { return chunks[chunk].memory.get() + columnOffset[id]; }
+
+private:
+  friend class World;
+
+  struct Chunk {
+    std::unique_ptr<unsigned char[]> memory;
+    uint32_t count = 0;
+  };
+
+  ComponentMask mask;
+  std::vector<ComponentId> components;
+  uint32_t columnOffset[MAX_COMPONENT_TYPES];
+  uint32_t capacity;
+  std::vector<Chunk> chunks;   // All full except the last
+  std::unique_ptr<unsigned char[]> spareChunk;   // Kept when the last chunk empties
+  size_t entityCount;
+
+  // Append a row (uninitialized) and return where it went
+  void pushRow(uint32_t& chunk, uint32_t& row);
+
+  // Append up to maxRows rows to the last chunk (a new one if it is full); returns how many
+  uint32_t pushRows(size_t maxRows, uint32_t& chunk, uint32_t& firstRow);
+
+  // Drop the last row
+  void popRow();
+};
+
+// One chunk of a query result
+class ChunkView
+{
+public:
+  ChunkView(const Archetype& archetype, size_t chunk) : archetype(archetype), chunk(chunk) {}
+
+  size_t size() const { return archetype.getChunkSize(chunk); }
+  const Entity* entities() const { return archetype.entities(chunk); }
+
+  // Component array of this chunk; T must be part of the query (or otherwise present)
+  template <typename T>
+  T* get() const { return static_cast<T*>(archetype.column(chunk, componentId<T>())); }
+
+  template <typename T>
+  bool has() const { return archetype.has(componentId<T>()); }
+
+private:
+  const Archetype& archetype;
+  size_t chunk;
+};
+
+class World
+{
+public:
+  World() = default;
+  World(const World&) = delete;
+  World& operator=(const World&) = delete;
+
+  // New entity with exactly these components
+  template <typename... Ts>
+  Entity create(const Ts&... components)
+  {
+    Entity entity = allocate(componentMask<Ts...>());
+    (writeComponent(entity, components), ...);
+    return entity;
+  }
+
+  // count new entities with exactly components Ts, appended chunk by chunk. Components start
+  // uninitialized: fill(ChunkView chunk, size_t firstRow, size_t rowCount, size_t batchIndex)
+  // must write every Ts for rows [firstRow, firstRow + rowCount), which are batch items
+  // [batchIndex, batchIndex + rowCount).
+  template <typename... Ts, typename Fn>
+  void createBatch(size_t count, Fn&& fill)
+  {
+    Archetype* archetype = beginBatch(componentMask<Ts...>(), count);
+    for (size_t done = 0; done < count;)
+    {
+      uint32_t chunk, firstRow;
+      uint32_t rows = allocateRun(*archetype, count - done, chunk, firstRow);
+      fill(ChunkView(*archetype, chunk), (size_t)firstRow, (size_t)rows, done);
+      done += rows;
+    }
+  }
+
+  // Destroying moves the archetype's last entity into the gap, so it must not happen while
+  // iterating that archetype; use destroyDeferred from inside a query
+  bool destroy(Entity entity);
+  void destroyDeferred(Entity entity) { pendingDestroy.push_back(entity); }
+  void flushDestroyed();
+
+  bool isAlive(Entity entity) const { return entities.contains(entity); }
+
+  // Component of an entity, nullptr if the entity is stale or lacks it. Valid until the
+  // next structural change (create, destroy, add, remove).
+  template <typename T>
+  T* get(Entity entity)
+  {
+    const EntityLocation* location = entities.get(entity);
+    if (!location || !location->archetype->has(componentId<T>()))
+      return nullptr;
+    return static_cast<T*>(location->archetype->column(location->chunk, componentId<T>())) + location->row;
+  }
+
+  template <typename T>
+  bool has(Entity entity) const
+  {
+    const EntityLocation* location = entities.get(entity);
+    return location && location->archetype->has(componentId<T>());
+  }
+
+  // Add (or overwrite) a component; moves the entity to another archetype
+  template <typename T>
+  void add(Entity entity, const T& value)
+  {
+    const EntityLocation* location = entities.get(entity);
+    if (!location)
+      return;
+    if (!location->archetype->has(componentId<T>()))
+      moveToArchetype(entity, location->archetype->getMask() | componentMask<T>());
+    writeComponent(entity, value);
+  }
+
+  template <typename T>
+  void remove(Entity entity)
+  {
+    const EntityLocation* location = entities.get(entity);
+    if (location && location->archetype->has(componentId<T>()))
+      moveToArchetype(entity, location->archetype->getMask() & ~componentMask<T>());
+  }
+
+  // Calls fn(ChunkView) for every non-empty chunk whose archetype has all of Ts. If fn
+  // returns bool, returning false stops the walk. Entities created meanwhile may or may
+  // not be visited.
+  template <typename... Ts, typename Fn>
+  void forEachChunk(Fn&& fn)
+  {
+    ComponentMask query = componentMask<Ts...>();
+    for (size_t a = 0; a < archetypes.size(); a++)
+    {
+      Archetype& archetype = *archetypes[a];
+      if ((archetype.getMask() & query) != query)
+        continue;
+      for (size_t c = 0; c < archetype.getChunkCount(); c++)
+      {
+        if (archetype.getChunkSize(c) == 0)
+          continue;
+        if constexpr (std::is_same<decltype(fn(std::declval<ChunkView>())), bool>::value)
+        {
+          if (!fn(ChunkView(archetype, c)))
+            return;
+        }
+        else
+        {
+          fn(ChunkView(archetype, c));
+        }
+      }
+    }
+  }
+
+  // Per-entity convenience over forEachChunk: fn(Entity, Ts&...)
+  template <typename... Ts, typename Fn>
+  void each(Fn&& fn)
+  {
+    forEachChunk<Ts...>([&](ChunkView chunk) {
+      std::tuple<Ts*...> columns(chunk.template get<Ts>()...);
+      const Entity* handles = chunk.entities();
+      for (size_t i = 0, n = chunk.size(); i < n; i++)
+        fn(handles[i], std::get<Ts*>(columns)[i]...);
+    });
+  }
+
+  // Entities having all of Ts
+  template <typename... Ts>
+  size_t count() const
+  {
+    ComponentMask query = componentMask<Ts...>();
+    size_t total = 0;
+    for (const auto& archetype : archetypes)
+    {
+      if ((archetype->getMask() & query) == query)
+        total += archetype->size();
+    }
+    return total;
+  }
+
+  // Destroy every entity having all of Ts
+  template <typename... Ts>
+  void destroyAll() { destroyMatching(componentMask<Ts...>()); }
+
+  size_t size() const { return entities.size(); }
+  size_t getArchetypeCount() const { return archetypes.size(); }
+
+  void clear();
+
+private:
+  SlotMap<EntityLocation> entities;
+  std::vector<std::unique_ptr<Archetype>> archetypes;
+  std::unordered_map<ComponentMask, Archetype*> archetypeByMask;
+  std::vector<Entity> pendingDestroy;
+
+  Archetype* findOrCreateArchetype(ComponentMask mask);
+
+  // New entity with an uninitialized row in the archetype for mask
+  Entity allocate(ComponentMask mask);
+
+  // Batch creation: reserve entity records, then register runs of rows within one chunk
+  Archetype* beginBatch(ComponentMask mask, size_t count);
+  uint32_t allocateRun(Archetype& archetype, size_t maxRows, uint32_t& chunk, uint32_t& firstRow);
+
+  // Remove a row, filling the gap with the archetype's last entity
+  void removeRow(Archetype& archetype, uint32_t chunk, uint32_t row);
+
+  void moveToArchetype(Entity entity, ComponentMask mask);
+  void destroyMatching(ComponentMask query);
+
+  template <typename T>
+  void writeComponent(Entity entity, const T& value)
+  {
+    std::memcpy(static_cast<void*>(get<T>(entity)), &value, sizeof(T));
+  }
+};
+
+// Ordered per-frame systems. A system typically walks one query with forEachChunk; destroys
+// deferred by a system are applied before the next one runs.
+class SystemScheduler
+{
+public:
+  using System = std::function<void(World&, float)>;
+
+  // name must outlive the scheduler (it labels the profiler zone)
+  void add(const char* name, System system);
+
+  void run(World& world, float deltaTime);
+
+  size_t size() const { return systems.size(); }
+
+private:
+  struct Entry {
+    const char* name;
+    System run;
+  };
+
+  std::vector<Entry> systems;
+};
@@ -0,0 +1,264 @@
+#include "emitter.h"
+#include "components.h"
+#include "projectile.h"
+#include "asset_pack.h"
+#include "profiler.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace
+{
+  const float DEGREES = (float)M_PI / 180.0f;
+  const float FULL_TURN = 2.0f * (float)M_PI;
+
+  struct EmitterPreset {
+    const char* name;
+    const char* text;
+  };
+
+  // Rifle matches the original hardwired shot: 200 ms +- 2%, 1% spray, speed 1.5
+  const EmitterPreset PRESETS[] = {
+    { "rifle", "pattern spread\nrate 5\ncount 1\nspeed 1.5\nspray 1\ntiming_error 2\n" },
+    { "fan", "pattern spread\nrate 3\ncount 7\narc 60\nspeed 1.5\nspray 0.5\n" },
+    { "shotgun", "pattern burst\nrate 1.5\ncount 12\narc 30\nspeed 1.8\nspeed_variance 0.2\n" },
+    { "ring", "pattern ring\nrate 2\ncount 36\nspeed 1.2\nspray 0\n" },
+    { "spiral", "pattern spiral\nrate 30\ncount 4\nspin 200\nspeed 1.3\nspray 0\n" },
+    { "stress", "pattern ring\nrate 60\ncount 200\nspeed 1.0\nspray 2\n" },   // ~60k live projectiles
+    { "seeker", "pattern spread\nrate 4\ncount 5\narc 90\nspeed 1.2\nspray 1\nhoming 270\nretarget 0.25\n" },
+    { "rocket", "pattern spread\nrate 1.5\ncount 1\nspeed 1.0\nspray 0.5\nblast 0.5\nblast_damage 3\n" },
+  };
+
+  bool parsePattern(const std::string& word, EmitterPattern& out)
+  {
+    if (word == "spread") out = EmitterPattern::Spread;
+    else if (word == "ring") out = EmitterPattern::Ring;
+    else if (word == "spiral") out = EmitterPattern::Spiral;
+    else if (word == "burst") out = EmitterPattern::Burst;
+    else return false;
+    return true;
+  }
+}
+
+bool EmitterDesc::parse(const std::string& text)
+{
+  EmitterDesc parsed;
+
+  std::istringstream lines(text);
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line))
+  {
+    lineNumber++;
+    size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream words(line);
+    std::string key;
+    if (!(words >> key))
+      continue; // Blank line
+
+    bool valid = false;
+    if (key == "pattern")
+    {
+      std::string value;
+      valid = (bool)(words >> value) && parsePattern(value, parsed.pattern);
+    }
+    else if (key == "count")
+    {
+      valid = (bool)(words >> parsed.count) && parsed.count > 0;
+    }
+    else if (key == "blast_damage")
+    {
+      valid = (bool)(words >> parsed.blastDamage) && parsed.blastDamage > 0;
+    }
+    else
+    {
+      float value;
+      valid = (bool)(words >> value);
+      if (key == "rate") { parsed.rate = value; valid = valid && value > 0.0f; }
+      else if (key == "arc") parsed.arc = value * DEGREES;
+      else if (key == "spin") parsed.spin = value * DEGREES;
+      else if (key == "speed") parsed.speed = value;
+      else if (key == "speed_variance") { parsed.speedVariance = value; valid = valid && value >= 0.0f && value < 1.0f; }
+      else if (key == "spray") parsed.sprayPercent = value;
+      else if (key == "timing_error")
+      {
+        // From 100 up an interval could come out zero or negative and update would never stop firing
+        parsed.timingErrorPercent = value;
+        valid = valid && value >= 0.0f && value < 100.0f;
+      }
+      else if (key == "homing") { parsed.homing = value * DEGREES; valid = valid && value >= 0.0f; }
+      else if (key == "retarget") { parsed.retarget = value; valid = valid && value > 0.0f; }
+      else if (key == "blast") { parsed.blastRadius = value; valid = valid && value >= 0.0f; }
+      else valid = false;
+    }
+
+    if (!valid)
+    {
+      std::cout << "Invalid emitter line " << lineNumber << ": " << line << std::endl;
+      return false;
+    }
+  }
+
+  *this = parsed;
+  return true;
+}
+
+bool EmitterDesc::loadPreset(const std::string& name)
+{
+  for (const EmitterPreset& preset : PRESETS)
+  {
+    if (name == preset.name)
+      return parse(AssetPack::resolveText("emitters/" + name + ".txt", preset.text));
+  }
+
+  std::cout << "Unknown emitter preset: " << name << std::endl;
+  return false;
+}
+
+size_t EmitterDesc::getPresetCount()
+{
+  return sizeof(PRESETS) / sizeof(PRESETS[0]);
+}
+
+const char* EmitterDesc::getPresetName(size_t index)
+{
+  return PRESETS[index].name;
+}
+
+EmitterSystem::EmitterSystem(World& world, ProjectileManager& projectiles)
+  : world(world), projectiles(projectiles), rng(Random::makeRng("emitters"))
+{
+}
+
+void EmitterSystem::ShotQueue::clear()
+{
+  xs.clear();
+  ys.clear();
+  angles.clear();
+  speeds.clear();
+  ages.clear();
+  turnRates.clear();
+  retargetIntervals.clear();
+  retargetDelays.clear();
+  blastRadii.clear();
+  blastDamages.clear();
+}
+
+size_t EmitterSystem::getLastShotCount() const
+{
+  size_t count = 0;
+  for (const ShotQueue& queue : queues)
+    count += queue.xs.size();
+  return count;
+}
+
+void EmitterSystem::update(float deltaTime)
+{
+  PROFILE_ZONE("Emitters");
+  for (ShotQueue& queue : queues)
+    queue.clear();
+
+  world.forEachChunk<Position, Emitter>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    Emitter* emitter = chunk.get<Emitter>();
+    const Rotation* rotation = chunk.has<Rotation>() ? chunk.get<Rotation>() : nullptr;
+
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+    {
+      Emitter& e = emitter[i];
+      const EmitterDesc& desc = e.desc;
+      if (desc.rate <= 0.0f || desc.count <= 0)
+        continue;
+
+      float aim = rotation ? rotation[i].angle : 0.0f;
+      float interval = 1.0f / desc.rate;
+      e.cooldown -= deltaTime;
+      while (e.cooldown <= 0.0f)
+      {
+        // -cooldown is how long ago this volley was due
+        queueVolley(desc, position[i].x, position[i].y, aim, e.phase, -e.cooldown);
+        e.phase = std::fmod(e.phase + desc.spin * interval, FULL_TURN);
+        e.cooldown += interval * (1.0f + rng.uniform(-1.0f, 1.0f) * desc.timingErrorPercent / 100.0f);
+      }
+    }
+  });
+
+  for (const ShotQueue& queue : queues)
+  {
+    if (queue.xs.empty())
+      continue;
+    bool homing = !queue.turnRates.empty(), explosive = !queue.blastRadii.empty();
+    projectiles.spawnBatch(queue.xs.size(), queue.xs.data(), queue.ys.data(), queue.angles.data(), queue.speeds.data(),
+      queue.ages.data(), homing ? queue.turnRates.data() : nullptr, homing ? queue.retargetIntervals.data() : nullptr,
+      homing ? queue.retargetDelays.data() : nullptr, explosive ? queue.blastRadii.data() : nullptr,
+      explosive ? queue.blastDamages.data() : nullptr);
+  }
+}
+
+void EmitterSystem::queueVolley(const EmitterDesc& desc, float x, float y, float aim, float phase, float age)
+{
+  bool homing = desc.homing > 0.0f, explosive = desc.blastRadius > 0.0f;
+  ShotQueue& queue = queues[(homing ? 1 : 0) | (explosive ? 2 : 0)];
+  size_t count = (size_t)desc.count;
+  size_t first = queue.xs.size();
+  queue.xs.resize(first + count, x);
+  queue.ys.resize(first + count, y);
+  queue.ages.resize(first + count, age);
+  queue.angles.resize(first + count);
+  queue.speeds.resize(first + count);
+  if (homing)
+  {
+    queue.turnRates.resize(first + count, desc.homing);
+    queue.retargetIntervals.resize(first + count, desc.retarget);
+
+    // First lookups spread across one interval, so a volley does not retarget all at once
+    queue.retargetDelays.resize(first + count);
+    rng.fillUniform(queue.retargetDelays.data() + first, count, 0.0f, desc.retarget);
+  }
+  if (explosive)
+  {
+    queue.blastRadii.resize(first + count, desc.blastRadius);
+    queue.blastDamages.resize(first + count, desc.blastDamage);
+  }
+
+  // Three uniforms in [-1, 1) per shot: spray, speed, and the burst cone
+  noise.resize(count * 3);
+  rng.fillUniform(noise.data(), noise.size(), -1.0f, 1.0f);
+  const float* spray = noise.data();
+  const float* speedNoise = spray + count;
+  const float* cone = speedNoise + count;
+
+  float sprayRadians = desc.sprayPercent / 100.0f * FULL_TURN;
+  float* angle = queue.angles.data() + first;
+  float* speed = queue.speeds.data() + first;
+  for (size_t k = 0; k < count; k++)
+  {
+    float base;
+    switch (desc.pattern)
+    {
+    case EmitterPattern::Spread:
+      base = count == 1 ? aim : aim - desc.arc * 0.5f + desc.arc * k / (count - 1);
+      break;
+    case EmitterPattern::Ring:
+      base = aim + FULL_TURN * k / count;
+      break;
+    case EmitterPattern::Spiral:
+      base = phase + FULL_TURN * k / count;
+      break;
+    default: // Burst
+      base = aim + cone[k] * desc.arc * 0.5f;
+      break;
+    }
+
+    angle[k] = base + spray[k] * sprayRadians;
+    speed[k] = desc.speed * (1.0f + speedNoise[k] * desc.speedVariance);
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ecs.h"
+#include "rng.h"
+
+#include <string>
+#include <vector>
+
+class ProjectileManager;
+
+// How a volley's projectiles are laid out
+enum class EmitterPattern {
+  Spread,   // count shots evenly across arc, centered on the aim
+  Ring,     // count shots evenly around the full circle, starting at the aim
+  Spiral,   // Ring that turns by spin every second, ignoring the aim
+  Burst     // count shots at random inside arc, with random speed (shotgun)
+};
+
+// Weapon description. Text format, one "key value" per line ('#' starts a comment):
+//   pattern spread|ring|spiral|burst
+//   rate <volleys per second>        count <shots per volley>
+//   arc <degrees>                    spin <degrees per second>
+//   speed <units per second>         speed_variance <fraction below 1, +->
+//   spray <percent of a full turn, +- random aim error per shot>
+//   timing_error <percent below 100, +- random change of each volley interval>
+//   homing <degrees per second turn toward the nearest enemy, 0 flies straight>
+//   retarget <seconds between nearest-enemy lookups of a homing shot>
+//   blast <radius of the explosion on impact, 0 for none>
+//   blast_damage <hit points at the centre of the explosion>
+struct EmitterDesc {
+  EmitterPattern pattern = EmitterPattern::Spread;
+  float rate = 5.0f;
+  int count = 1;
+  float arc = 0.0f;              // Radians
+  float spin = 0.0f;             // Radians per second
+  float speed = 1.5f;
+  float speedVariance = 0.0f;
+  float sprayPercent = 1.0f;
+  float timingErrorPercent = 0.0f;
+  float homing = 0.0f;           // Radians per second
+  float retarget = 0.25f;        // Seconds
+  float blastRadius = 0.0f;
+  int blastDamage = 3;
+
+  // Replace the settings from a descriptor; prints the offending line on error
+  bool parse(const std::string& text);
+
+  // Built-in preset by name; a mounted asset pack can override it as "emitters/<name>.txt"
+  bool loadPreset(const std::string& name);
+
+  static size_t getPresetCount();
+  static const char* getPresetName(size_t index);
+};
+
+// Component: fires from the entity's Position, aimed along its Rotation when it has one
+struct Emitter {
+  EmitterDesc desc;
+  float cooldown;   // Seconds until the next volley
+  float phase;      // Spiral turn so far, radians
+};
+
+// Fires every volley that came due this frame, from all emitters, as one projectile batch.
+// Run it after movement and aging: shots fired mid-frame start as far along as they would
+// have travelled by the end of it.
+class EmitterSystem
+{
+public:
+  EmitterSystem(World& world, ProjectileManager& projectiles);
+
+  void update(float deltaTime);
+
+  // Projectiles fired by the last update
+  size_t getLastShotCount() const;
+
+private:
+  World& world;
+  ProjectileManager& projectiles;
+  Rng rng;
+
+  // Shots queued this frame (SoA, handed to ProjectileManager::spawnBatch), one batch per
+  // combination of the optional components: queue index bit 0 is homing, bit 1 explosive
+  struct ShotQueue {
+    std::vector<float> xs, ys, angles, speeds, ages;
+    std::vector<float> turnRates, retargetIntervals, retargetDelays;   // Homing shots only
+    std::vector<float> blastRadii;                     // Explosive shots only
+    std::vector<int> blastDamages;
+    void clear();
+  } queues[4];
+  std::vector<float> noise;
+
+  void queueVolley(const EmitterDesc& desc, float x, float y, float aim, float phase, float age);
+};
@@ -1,45 +1,78 @@
 #include "enemy.h"
 #include "shader.h"
 #include "texture_loader.h"
+#include "profiler.h"
+#include "fast_math.h"
 #include <glad/glad.h>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <bit>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-Enemy::Enemy(float startX, float startY, float vx, float vy)
-  : x(startX), y(startY), velX(vx), velY(vy), life(0.0f), frame(0),
-  hitPoints(3), size(1.0f), isAlive(true), spawnEffect(0.0f)
+namespace
 {
-}
-
-bool Enemy::takeDamage(int damage)
-{
-  hitPoints -= damage;
-  if (hitPoints <= 0)
+  // Spawn region: the visible square (with 2.5x zoom, roughly -2.5 to +2.5) minus a box
+  // around the player at the center
+  const float SPAWN_OUTER = 2.2f;
+  const float SPAWN_INNER = 0.8f;
+
+  // Ring pattern radii; the inner one clears the corners of the player box
+  const float RING_INNER = 1.2f;
+  const float RING_OUTER = 2.2f;
+
+  // Enemies close half the gap to the flow field heading in about a third of a second
+  const float ENEMY_TURN_RATE = 2.0f;
+
+  // prepareTargeting calls that refit the targeting tree between rebuilds. Enemies walk under
+  // 0.005 a frame, but at 50k that is a fair part of their spacing: lookups slow by about a
+  // third after 7 refits and double after 15, while a rebuild costs about 25 refits.
+  const int TARGET_REFITS_PER_BUILD = 7;
+
+  // Uniform point in the spawn region from three uniforms in [0, 1), without rejection: the
+  // region splits into a top and bottom band and two side blocks, u0 picks one by area and
+  // u1, u2 place the point inside it
+  void sampleScreenArea(float u0, float u1, float u2, float& x, float& y)
   {
-    isAlive = false;
-    return true; // Enemy died
+    const float depth = SPAWN_OUTER - SPAWN_INNER;
+    const float band = 2.0f * SPAWN_OUTER * depth;
+    const float side = 2.0f * SPAWN_INNER * depth;
+
+    float t = u0 * 2.0f * (band + side);
+    float d = SPAWN_INNER + u2 * depth;
+    if (t < 2.0f * band)
+    {
+      x = (u1 * 2.0f - 1.0f) * SPAWN_OUTER;
+      y = t < band ? d : -d;
+    }
+    else
+    {
+      x = t < 2.0f * band + side ? d : -d;
+      y = (u1 * 2.0f - 1.0f) * SPAWN_INNER;
+    }
   }
-  return false; // Enemy still alive
 }
 
-bool Enemy::containsPoint(float pointX, float pointY) const
+const char* getCollisionBackendName(CollisionBackend backend)
 {
-  if (!isAlive) return false;
-
-  // Simple box collision (enemy size is roughly 0.3 * size)
-  float halfSize = 0.15f * size;
-  return (pointX >= x - halfSize && pointX <= x + halfSize &&
-    pointY >= y - halfSize && pointY <= y + halfSize);
+  switch (backend)
+  {
+  case CollisionBackend::Grid: return "grid";
+  case CollisionBackend::SweepAndPrune: return "sweep and prune";
+  default: return "brute force";
+  }
 }
 
-EnemyManager::EnemyManager()
-  : maxEnemies(20), spawnRate(0.5f), spawnTimer(0.0f), VAO(0), VBO(0), EBO(0), texture(0),
-  gen(rd()), posDis(-2.0f, 2.0f), speedDis(0.1f, 0.3f) // Spawn within visible range
+EnemyManager::EnemyManager(World& world)
+  : world(world), maxEnemies(20), spawnRate(0.5f), spawnTimer(0.0f), rng(Random::makeRng("enemies")),
+  colliderDeltaTime(0.0f), collisionBackend(CollisionBackend::Grid), preparedBackend(CollisionBackend::Grid),
+  rangeStamp(0), VAO(0), VBO(0), EBO(0), instanceVBO(0), instanceCapacity(0), texture(0),
+  samplerProfile(SamplerProfile::PixelArt),
+  crowd(jobs), crowdSteering(true),
+  overlapResolution(true)
 {
 }
 
@@ -48,33 +81,51 @@ EnemyManager::~EnemyManager()
   if (VAO) glDeleteVertexArrays(1, &VAO);
   if (VBO) glDeleteBuffers(1, &VBO);
   if (EBO) glDeleteBuffers(1, &EBO);
-  if (texture) glDeleteTextures(1, &texture);
+  if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+  if (texture) TextureLoader::releaseTexture(texture);
+  clear();
 }
 
 bool EnemyManager::initialize(const char* texturePath)
 {
-  setupMesh();
-
   // Load texture
-  texture = loadTexture(texturePath);
-  if (texture == 0)
+  unsigned int loaded = loadTexture(texturePath);
+  if (loaded == 0)
   {
     std::cout << "Failed to load enemy texture: " << texturePath << std::endl;
     return false;
   }
 
+  return initializeWithTexture(loaded);
+}
+
+bool EnemyManager::initializeWithTexture(unsigned int textureID)
+{
+  if (textureID == 0)
+    return false;
+
+  setupMesh();
+
+  texture = textureID;
+  TextureSampler::prepareTexture(texture, samplerProfile);
   return true;
 }
 
+void EnemyManager::setSamplerProfile(SamplerProfile profile)
+{
+  samplerProfile = profile;
+  TextureSampler::prepareTexture(texture, samplerProfile);
+}
+
 void EnemyManager::setupMesh()
 {
-  // Vertex data for enemy quad
+  // Unit quad, scaled per enemy by its instance transform; the vertex shader picks each
+  // corner's UV from the instance by its index, so the order matches FrameUV
   float enemyVertices[] = {
-    // positions        // texture coords (will be updated dynamically)
-     0.15f,  0.15f, 0.0f,  0.2f, 1.0f,     // top right 
-     0.15f, -0.15f, 0.0f,  0.2f, 0.8f,     // bottom right
-    -0.15f, -0.15f, 0.0f,  0.0f, 0.8f,     // bottom left
-    -0.15f,  0.15f, 0.0f,  0.0f, 1.0f      // top left 
+     1.0f,  1.0f, 0.0f,   // top right
+     1.0f, -1.0f, 0.0f,   // bottom right
+    -1.0f, -1.0f, 0.0f,   // bottom left
+    -1.0f,  1.0f, 0.0f    // top left
   };
 
   unsigned int indices[] = {
@@ -85,233 +136,705 @@ void EnemyManager::setupMesh()
   glGenVertexArrays(1, &VAO);
   glGenBuffers(1, &VBO);
   glGenBuffers(1, &EBO);
+  glGenBuffers(1, &instanceVBO);
 
   glBindVertexArray(VAO);
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(enemyVertices), enemyVertices, GL_DYNAMIC_DRAW);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(enemyVertices), enemyVertices, GL_STATIC_DRAW);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
   // Position attribute
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
   glEnableVertexAttribArray(0);
-  // Texture coordinate attribute
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+
+  // Per-instance attributes: the transform's four columns, then the frame UVs in two halves
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  for (unsigned int column = 0; column < 4; column++)
+  {
+    glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+      (void*)(offsetof(SpriteInstance, transform) + column * 4 * sizeof(float)));
+    glEnableVertexAttribArray(2 + column);
+    glVertexAttribDivisor(2 + column, 1);
+  }
+  for (unsigned int half = 0; half < 2; half++)
+  {
+    glVertexAttribPointer(6 + half, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+      (void*)(offsetof(SpriteInstance, uv) + half * 4 * sizeof(float)));
+    glEnableVertexAttribArray(6 + half);
+    glVertexAttribDivisor(6 + half, 1);
+  }
+
+  glBindVertexArray(0);
 }
 
 unsigned int EnemyManager::loadTexture(const char* path)
 {
-  return TextureLoader::loadTexture(path);
+  // Shared through the registry, so another system using the same sheet reuses this upload
+  return TextureLoader::acquireTexture(path);
 }
 
 void EnemyManager::update(float deltaTime)
 {
+  PROFILE_ZONE("Enemy update");
+
   // Try to spawn new enemies
   trySpawnEnemy(deltaTime);
 
-  // Update all enemies
-  for (auto& enemy : enemies)
+  flowField.update();
+  steerAlongFlowField(deltaTime);
+  if (crowdSteering)
+    steerAroundNeighbours(deltaTime);
+}
+
+void EnemyManager::steerAlongFlowField(float deltaTime)
+{
+  PROFILE_ZONE("Flow steering");
+  static_assert(sizeof(Position) == 2 * sizeof(float) && sizeof(Velocity) == 2 * sizeof(float) &&
+    sizeof(FlowSteering) == 2 * sizeof(float), "Steering reads the columns as packed float pairs");
+
+  // One batch per chunk: the columns already are the packed pairs FlowField::steer takes
+  world.forEachChunk<Position, Velocity, FlowSteering>([&](ChunkView chunk) {
+    flowField.steer(reinterpret_cast<const float*>(chunk.get<Position>()), reinterpret_cast<float*>(chunk.get<Velocity>()),
+      reinterpret_cast<const float*>(chunk.get<FlowSteering>()), chunk.size(), deltaTime);
+  });
+}
+
+void EnemyManager::steerAroundNeighbours(float deltaTime)
+{
+  size_t count = getEnemyCount();
+  if (count < 2)
+    return;
+
+  CrowdScratch& scratch = crowdScratch;
+  scratch.x.resize(count);
+  scratch.y.resize(count);
+  scratch.velX.resize(count);
+  scratch.velY.resize(count);
+  scratch.outVelX.resize(count);
+  scratch.outVelY.resize(count);
+
+  size_t row = 0;
+  world.forEachChunk<Position, Velocity, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const Velocity* velocity = chunk.get<Velocity>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, row++)
+    {
+      scratch.x[row] = position[i].x;
+      scratch.y[row] = position[i].y;
+      scratch.velX[row] = velocity[i].x;
+      scratch.velY[row] = velocity[i].y;
+    }
+  });
+
+  crowd.steer(scratch.x.data(), scratch.y.data(), scratch.velX.data(), scratch.velY.data(), count, deltaTime,
+    scratch.outVelX.data(), scratch.outVelY.data());
+
+  // Same walk, same order
+  row = 0;
+  world.forEachChunk<Position, Velocity, EnemyBody>([&](ChunkView chunk) {
+    Velocity* velocity = chunk.get<Velocity>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, row++)
+      velocity[i] = Velocity{ scratch.outVelX[row], scratch.outVelY[row] };
+  });
+}
+
+void EnemyManager::resolveOverlaps()
+{
+  size_t count = getEnemyCount();
+  if (!overlapResolution || count < 2)
+    return;
+
+  CrowdScratch& scratch = crowdScratch;
+  scratch.x.resize(count);
+  scratch.y.resize(count);
+  scratch.halfSize.resize(count);
+
+  size_t row = 0;
+  world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const EnemyBody* body = chunk.get<EnemyBody>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, row++)
+    {
+      scratch.x[row] = position[i].x;
+      scratch.y[row] = position[i].y;
+      scratch.halfSize[row] = 0.15f * body[i].size;
+    }
+  });
+
+  crowd.resolveOverlaps(scratch.x.data(), scratch.y.data(), scratch.halfSize.data(), count);
+
+  row = 0;
+  world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+    Position* position = chunk.get<Position>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, row++)
+      position[i] = Position{ scratch.x[row], scratch.y[row] };
+  });
+}
+
+void EnemyManager::prepareTargeting()
+{
+  PROFILE_ZONE("Targeting tree");
+  // Tree items are entity slots rather than rows, so the tree outlives enemies dying and
+  // moving between rows: a slot without a live enemy reads as infinitely far. An enemy in a
+  // slot the tree does not know forces a rebuild; otherwise the tree is refit.
+  std::fill(targets.x.begin(), targets.x.end(), INFINITY);
+  std::fill(targets.y.begin(), targets.y.end(), INFINITY);
+  bool rebuild = targets.refits >= TARGET_REFITS_PER_BUILD;
+  world.forEachChunk<Position, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const Entity* entities = chunk.entities();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+    {
+      uint32_t slot = entities[i].index;
+      if (slot >= targets.entities.size())
+      {
+        targets.entities.resize(slot + 1);
+        targets.x.resize(slot + 1, INFINITY);
+        targets.y.resize(slot + 1, INFINITY);
+      }
+      if (targets.entities[slot] != entities[i])
+      {
+        targets.entities[slot] = entities[i];
+        rebuild = true;
+      }
+      targets.x[slot] = position[i].x;
+      targets.y[slot] = position[i].y;
+    }
+  });
+
+  if (rebuild)
   {
-    if (!enemy.isAlive) continue;
-
-    // Update position
-    enemy.x += enemy.velX * deltaTime;
-    enemy.y += enemy.velY * deltaTime;
-    enemy.life += deltaTime;
-    enemy.spawnEffect += deltaTime; // Update spawn effect timer
-
-    // Update animation frame (change frame based on time)
-    enemy.frame = (int)(enemy.life * 8.0f) % 24; // 8 fps, 24 frames
-
-    // Wrap around screen edges (larger boundaries)
-    if (enemy.x > 5.0f) enemy.x = -5.0f;
-    if (enemy.x < -5.0f) enemy.x = 5.0f;
-    if (enemy.y > 5.0f) enemy.y = -5.0f;
-    if (enemy.y < -5.0f) enemy.y = 5.0f;
+    targetTree.build(targets.x.data(), targets.y.data(), targets.entities.size());
+    targets.refits = 0;
   }
+  else
+  {
+    targetTree.refit(targets.x.data(), targets.y.data());
+    targets.refits++;
+  }
+}
 
-  // Remove dead enemies periodically
-  removeDeadEnemies();
+void EnemyManager::findNearestEnemies(const float* xs, const float* ys, size_t count, EnemyHandle* outEnemies)
+{
+  PROFILE_ZONE("Nearest enemies");
+  targets.items.resize(count);
+  targetTree.nearest(xs, ys, count, targets.items.data(), &jobs);
+  for (size_t k = 0; k < count; k++)
+  {
+    uint32_t item = targets.items[k];
+    outEnemies[k] = item == KdTree::NONE ? EnemyHandle() : targets.entities[item];
+  }
 }
 
 void EnemyManager::trySpawnEnemy(float deltaTime)
 {
+  PROFILE_ZONE("Spawn");
   spawnTimer += deltaTime;
 
-  // Check if we should spawn a new enemy
+  // Spawn everything that came due, so long frames or high rates don't lose spawns; at the
+  // cap the due spawns are dropped rather than saved up
   float spawnInterval = 1.0f / spawnRate; // Convert rate to interval
-  if (spawnTimer >= spawnInterval && getAliveEnemyCount() < maxEnemies)
+  if (spawnTimer < spawnInterval)
+    return;
+
+  size_t due = (size_t)(spawnTimer / spawnInterval);
+  spawnTimer -= due * spawnInterval;
+  if (due == 1)
+  {
+    if (getEnemyCount() < (size_t)maxEnemies)
+      spawnEnemyAtRandomLocation();
+  }
+  else
   {
-    spawnEnemyAtRandomLocation();
-    spawnTimer = 0.0f;
+    spawnBurst(due, SpawnPattern::ScreenArea);
   }
 }
 
-void EnemyManager::spawnEnemyAtRandomLocation()
+EnemyHandle EnemyManager::spawnEnemyAtRandomLocation()
 {
   float x, y;
   getRandomSpawnPosition(x, y);
 
   // Give enemy more varied movement patterns
-  float speed = speedDis(gen);
+  float speed = rng.uniform(0.1f, 0.3f);
 
   // 50% chance to move toward center, 50% chance for random movement
   float velX, velY;
-  if (gen() % 2 == 0)
+  if (rng.chance(0.5f))
   {
     // Move toward center with some randomness
-    float angleToCenter = atan2(-y, -x) + (posDis(gen) * 0.3f);
-    velX = cos(angleToCenter) * speed;
-    velY = sin(angleToCenter) * speed;
+    float angleToCenter = FastMath::atan2(-y, -x) + (rng.uniform(-2.0f, 2.0f) * 0.3f);
+    velX = FastMath::cos(angleToCenter) * speed;
+    velY = FastMath::sin(angleToCenter) * speed;
   }
   else
   {
     // Random movement direction
-    float randomAngle = posDis(gen) * M_PI; // Random angle
-    velX = cos(randomAngle) * speed;
-    velY = sin(randomAngle) * speed;
+    float randomAngle = rng.uniform(-2.0f, 2.0f) * M_PI; // Random angle
+    velX = FastMath::cos(randomAngle) * speed;
+    velY = FastMath::sin(randomAngle) * speed;
   }
 
-  enemies.emplace_back(x, y, velX, velY);
+  return spawnEnemy(x, y, velX, velY);
+}
+
+EnemyHandle EnemyManager::spawnEnemy(float x, float y, float velX, float velY)
+{
+  // 8 fps walk cycle, 3 hit points, wrapping around the larger play area
+  return world.create(Position{ x, y }, Velocity{ velX, velY }, Age{ 0.0f },
+    SpriteAnimation{ 8.0f, DinoSpriteSheet::frameCount, 0 }, Health{ 3 }, ScreenWrap{ 5.0f },
+    FlowSteering{ std::sqrt(velX * velX + velY * velY), ENEMY_TURN_RATE }, EnemyBody{ 1.0f });
 }
 
 void EnemyManager::getRandomSpawnPosition(float& x, float& y)
 {
   // Spawn enemies within visible range but not too close to center (player area)
-  // With 2.5x zoom, visible area is roughly -2.5 to +2.5
-
-  // Create a safe spawn zone: visible but not in center
-  std::uniform_real_distribution<float> spawnDis(-2.2f, 2.2f);
+  float u0 = rng.nextFloat();
+  float u1 = rng.nextFloat();
+  float u2 = rng.nextFloat();
+  sampleScreenArea(u0, u1, u2, x, y);
+}
 
-  // Try to avoid spawning too close to center (player is at 0,0)
-  do {
-    x = spawnDis(gen);
-    y = spawnDis(gen);
-  } while (abs(x) < 0.8f && abs(y) < 0.8f); // Avoid center area where player is
+size_t EnemyManager::spawnBurst(size_t count, SpawnPattern pattern)
+{
+  PROFILE_ZONE("Spawn burst");
+  size_t current = getEnemyCount();
+  if (current >= (size_t)maxEnemies)
+    return 0;
+  count = std::min(count, (size_t)maxEnemies - current);
+
+  // Scratch columns: six uniforms per enemy from one bulk draw, then position and heading
+  const size_t UNIFORMS = 6;
+  burstScratch.resize(count * (UNIFORMS + 5));
+  float* column = burstScratch.data();
+  rng.fillUniform(column, count * UNIFORMS, 0.0f, 1.0f);
+  const float* u0 = column;               // Region pick (screen area)
+  const float* u1 = column + count;       // Position
+  const float* u2 = column + count * 2;   // Position
+  const float* u3 = column + count * 3;   // Heading mode
+  const float* u4 = column + count * 4;   // Heading angle
+  const float* u5 = column + count * 5;   // Speed
+  float* xs = column + count * 6;
+  float* ys = column + count * 7;
+  float* angles = column + count * 8;
+  float* sines = column + count * 9;
+  float* cosines = column + count * 10;
+
+  // Positions
+  if (pattern == SpawnPattern::Ring)
+  {
+    // Area-uniform radius: r^2 is uniform between the inner and outer radius squared
+    for (size_t i = 0; i < count; i++)
+      angles[i] = u2[i] * 2.0f * (float)M_PI;
+    FastMath::sinCos(angles, sines, cosines, count);
+    for (size_t i = 0; i < count; i++)
+    {
+      float radius = std::sqrt(RING_INNER * RING_INNER + u1[i] * (RING_OUTER * RING_OUTER - RING_INNER * RING_INNER));
+      xs[i] = radius * cosines[i];
+      ys[i] = radius * sines[i];
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      sampleScreenArea(u0[i], u1[i], u2[i], xs[i], ys[i]);
+  }
 
-  // Give enemy random movement direction (not necessarily toward center)
-  // This makes spawning more dynamic and less predictable
+  // Headings, same mix as single spawns: half toward the center with some jitter, half random.
+  // The bearing from the center plus half a turn points back at it.
+  FastMath::atan2(ys, xs, angles, count);
+  for (size_t i = 0; i < count; i++)
+  {
+    float spread = u4[i] * 4.0f - 2.0f;
+    float towardCenter = angles[i] + FastMath::PI + spread * 0.3f;
+    float random = spread * (float)M_PI;
+    angles[i] = u3[i] < 0.5f ? towardCenter : random;
+  }
+  FastMath::sinCos(angles, sines, cosines, count);
+
+  // Same components as spawnEnemy, so the batch lands in the same archetype
+  world.createBatch<Position, Velocity, Age, SpriteAnimation, Health, ScreenWrap, FlowSteering, EnemyBody>(count,
+    [&](ChunkView chunk, size_t firstRow, size_t rowCount, size_t batchIndex) {
+      Position* position = chunk.get<Position>() + firstRow;
+      Velocity* velocity = chunk.get<Velocity>() + firstRow;
+      Age* age = chunk.get<Age>() + firstRow;
+      SpriteAnimation* sprite = chunk.get<SpriteAnimation>() + firstRow;
+      Health* health = chunk.get<Health>() + firstRow;
+      ScreenWrap* wrap = chunk.get<ScreenWrap>() + firstRow;
+      FlowSteering* steering = chunk.get<FlowSteering>() + firstRow;
+      EnemyBody* body = chunk.get<EnemyBody>() + firstRow;
+      for (size_t r = 0; r < rowCount; r++)
+      {
+        size_t i = batchIndex + r;
+        float speed = 0.1f + 0.2f * u5[i];
+        position[r] = Position{ xs[i], ys[i] };
+        velocity[r] = Velocity{ cosines[i] * speed, sines[i] * speed };
+        age[r] = Age{ 0.0f };
+        sprite[r] = SpriteAnimation{ 8.0f, DinoSpriteSheet::frameCount, 0 };
+        health[r] = Health{ 3 };
+        wrap[r] = ScreenWrap{ 5.0f };
+        steering[r] = FlowSteering{ speed, ENEMY_TURN_RATE };
+        body[r] = EnemyBody{ 1.0f };
+      }
+    });
+  return count;
 }
 
 bool EnemyManager::checkProjectileCollisions(float projX, float projY, float projRadius)
 {
-  for (auto& enemy : enemies)
-  {
-    if (enemy.containsPoint(projX, projY))
+  Entity killed;
+  bool hit = false;
+  world.forEachChunk<Position, Health, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    Health* health = chunk.get<Health>();
+    const EnemyBody* body = chunk.get<EnemyBody>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
     {
-      if (enemy.takeDamage(1))
+      // Circle against the enemy's box (enemy size is roughly 0.3 * size)
+      float halfSize = 0.15f * body[i].size;
+      if (pointBoxDistanceSquared(projX, projY, position[i].x - halfSize, position[i].y - halfSize,
+        position[i].x + halfSize, position[i].y + halfSize) > projRadius * projRadius)
+        continue;
+
+      hit = true;
+      if (--health[i].hitPoints <= 0)
       {
-        // Enemy died
+        killed = chunk.entities()[i];
         std::cout << "Enemy destroyed!" << std::endl;
       }
       else
       {
-        std::cout << "Enemy hit! HP remaining: " << enemy.hitPoints << std::endl;
+        std::cout << "Enemy hit! HP remaining: " << health[i].hitPoints << std::endl;
       }
-      return true; // Hit detected
+      return false; // Hit detected, stop the walk
     }
-  }
-  return false; // No hit
+    return true;
+  });
+
+  // Destroyed after the walk, since removal reorders the chunk; handles to it go stale
+  if (!killed.isNull())
+    world.destroy(killed);
+  return hit;
 }
 
-size_t EnemyManager::getAliveEnemyCount() const
+void EnemyManager::prepareCollision(float deltaTime, float reach)
 {
-  return std::count_if(enemies.begin(), enemies.end(),
-    [](const Enemy& e) { return e.isAlive; });
+  PROFILE_ZONE("Enemy colliders");
+  ColliderSnapshot& c = colliders;
+  size_t count = getEnemyCount();
+  c.entities.resize(count);
+  c.keys.resize(count);
+  for (std::vector<float>* column : { &c.x, &c.y, &c.velX, &c.velY, &c.halfSize, &c.minX, &c.minY, &c.maxX, &c.maxY })
+    column->resize(count);
+
+  size_t j = 0;
+  world.forEachChunk<Position, Velocity, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const Velocity* velocity = chunk.get<Velocity>();
+    const EnemyBody* body = chunk.get<EnemyBody>();
+    const Entity* entities = chunk.entities();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, j++)
+    {
+      // Same box as checkProjectileCollisions, covering where it was deltaTime ago too and
+      // grown by reach, so the broadphase finds boxes a projectile's radius away from its path
+      float halfSize = 0.15f * body[i].size;
+      float grown = halfSize + reach;
+      float startX = position[i].x - velocity[i].x * deltaTime;
+      float startY = position[i].y - velocity[i].y * deltaTime;
+      c.entities[j] = entities[i];
+      c.keys[j] = entities[i].index;
+      c.x[j] = position[i].x;
+      c.y[j] = position[i].y;
+      c.velX[j] = velocity[i].x;
+      c.velY[j] = velocity[i].y;
+      c.halfSize[j] = halfSize;
+      c.minX[j] = std::min(startX, position[i].x) - grown;
+      c.minY[j] = std::min(startY, position[i].y) - grown;
+      c.maxX[j] = std::max(startX, position[i].x) + grown;
+      c.maxY[j] = std::max(startY, position[i].y) + grown;
+    }
+  });
+
+  rangeMarks.assign(count, 0);
+  rangeStamp = 0;
+  rangeRows.resize(count);
+
+  colliderDeltaTime = deltaTime;
+  switch (collisionBackend)
+  {
+  case CollisionBackend::Grid:
+    colliderGrid.build(c.minX.data(), c.minY.data(), c.maxX.data(), c.maxY.data(), count);
+    break;
+  case CollisionBackend::SweepAndPrune:
+    colliderSweep.update(c.keys.data(), c.minX.data(), c.minY.data(), c.maxX.data(), c.maxY.data(), count);
+    break;
+  default:
+    c.indices.resize(count);
+    for (size_t i = 0; i < count; i++)
+      c.indices[i] = (uint32_t)i;
+    break;
+  }
+  preparedBackend = collisionBackend;
 }
 
-void EnemyManager::removeDeadEnemies()
+EnemyHandle EnemyManager::findFirstHit(float x, float y, float velX, float velY, float duration, float radius)
 {
-  enemies.erase(
-    std::remove_if(enemies.begin(), enemies.end(),
-      [](const Enemy& e) { return !e.isAlive; }),
-    enemies.end()
-  );
+  size_t hit = sweepColliders(x, y, velX, velY, duration, radius);
+  return hit == SIZE_MAX ? EnemyHandle() : colliders.entities[hit];
 }
 
-void EnemyManager::getFrameCoords(int frame, float coords[8])
+bool EnemyManager::sweepProjectile(float x, float y, float velX, float velY, float duration, float radius)
 {
-  // Sprite sheet: 120x120, 5x5 grid (24 frames total), each frame 24x24
-  // Same layout as the player dinosaur
+  size_t best = sweepColliders(x, y, velX, velY, duration, radius);
+  if (best == SIZE_MAX || !world.get<Health>(colliders.entities[best]))
+    return false; // Clear path, or destroyed by something else since prepareCollision
 
-  float frameWidth = 24.0f / 120.0f;   // 24/120 = 0.2
-  float frameHeight = 24.0f / 120.0f;  // 24/120 = 0.2
+  damageCollider(best, 1);
+  return true;
+}
 
-  int col = frame % 5;       // 0, 1, 2, 3, or 4
-  int row = frame / 5;       // 0, 1, 2, 3, or 4
+bool EnemyManager::sweepExplosive(float x, float y, float velX, float velY, float duration, float radius,
+  float blastRadius, int damage)
+{
+  float hitTime;
+  size_t best = sweepColliders(x, y, velX, velY, duration, radius, &hitTime);
+  if (best == SIZE_MAX)
+    return false;
 
-  float left = col * frameWidth;
-  float right = left + frameWidth;
-  float top = 1.0f - (row * frameHeight);      // Flip Y for OpenGL
-  float bottom = top - frameHeight;
+  // Blast at the projectile's position at the moment of impact
+  duration = std::min(duration, colliderDeltaTime);
+  float back = (1.0f - hitTime) * duration;
+  damageArea(x - velX * back, y - velY * back, blastRadius, damage);
+  return true;
+}
 
-  // Texture coordinates for quad
-  coords[0] = right; coords[1] = top;      // top right
-  coords[2] = right; coords[3] = bottom;   // bottom right  
-  coords[4] = left;  coords[5] = bottom;   // bottom left
-  coords[6] = left;  coords[7] = top;      // top left
+void EnemyManager::damageCollider(size_t row, int damage)
+{
+  ColliderSnapshot& c = colliders;
+  Health* health = world.get<Health>(c.entities[row]);
+  if (!health)
+    return;
+
+  // No per-hit logging here: sweeps and blasts land many hits per frame
+  health->hitPoints -= damage;
+  if (health->hitPoints <= 0)
+  {
+    world.destroy(c.entities[row]);
+    c.halfSize[row] = -1.0f;
+  }
 }
 
-void EnemyManager::render(std::shared_ptr<Shader> shader)
+size_t EnemyManager::queryCircle(float x, float y, float radius, EnemyHandle* outEnemies, size_t capacity)
 {
-  shader->use();
-  glBindVertexArray(VAO);
+  return queryCapsule(x, y, x, y, radius, outEnemies, capacity);
+}
 
-  // Bind enemy texture
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, texture);
-  shader->setInt("ourTexture", 0);
+size_t EnemyManager::queryCapsule(float x0, float y0, float x1, float y1, float radius, EnemyHandle* outEnemies,
+  size_t capacity)
+{
+  size_t count = collectInRange(x0, y0, x1, y1, radius, capacity);
+  for (size_t k = 0; k < count; k++)
+    outEnemies[k] = colliders.entities[rangeRows[k]];
+  return count;
+}
+
+size_t EnemyManager::damageArea(float x, float y, float radius, int damage)
+{
+  const ColliderSnapshot& c = colliders;
+  size_t count = collectInRange(x, y, x, y, radius, rangeRows.size());
+  size_t damaged = 0;
+  for (size_t k = 0; k < count; k++)
+  {
+    uint32_t row = rangeRows[k];
+    float h = c.halfSize[row];
+    float distance = std::sqrt(pointBoxDistanceSquared(x, y, c.x[row] - h, c.y[row] - h, c.x[row] + h, c.y[row] + h));
+    int falloff = (int)std::ceil(damage * (1.0f - distance / radius));
+    if (falloff <= 0)
+      continue;
+    damageCollider(row, falloff);
+    damaged++;
+  }
+  return damaged;
+}
 
-  for (const auto& enemy : enemies)
+size_t EnemyManager::collectInRange(float x0, float y0, float x1, float y1, float radius, size_t capacity)
+{
+  const ColliderSnapshot& c = colliders;
+  capacity = std::min(capacity, rangeRows.size());
+  if (++rangeStamp == 0)
   {
-    if (!enemy.isAlive) continue;
+    std::fill(rangeMarks.begin(), rangeMarks.end(), 0);
+    rangeStamp = 1;
+  }
 
-    // Get texture coordinates for current frame
-    float frameCoords[8];
-    getFrameCoords(enemy.frame, frameCoords);
+  // Candidates by the capsule's bounds (the snapshot boxes also cover where enemies were a
+  // frame ago, so they hold the current ones), then the exact test on the current box
+  float minX = std::min(x0, x1) - radius, maxX = std::max(x0, x1) + radius;
+  float minY = std::min(y0, y1) - radius, maxY = std::max(y0, y1) + radius;
+  float radiusSquared = radius * radius;
+  size_t count = 0;
+  auto visit = [&](const BoxSpan& boxes) {
+    for (size_t first = 0; first < boxes.count && count < capacity; first += BoxKernel::BLOCK)
+    {
+      uint32_t mask = BoxKernel::overlapMask(boxes, first, minX, minY, maxX, maxY);
+      for (; mask && count < capacity; mask &= mask - 1)
+      {
+        uint32_t j = boxes.items[first + std::countr_zero(mask)];
+        float h = c.halfSize[j];
+        if (h < 0.0f || rangeMarks[j] == rangeStamp)
+          continue; // Killed earlier this frame, or already taken from another cell
+        rangeMarks[j] = rangeStamp;
+        if (segmentBoxDistanceSquared(x0, y0, x1, y1, c.x[j] - h, c.y[j] - h, c.x[j] + h, c.y[j] + h) <= radiusSquared)
+          rangeRows[count++] = j;
+      }
+    }
+  };
 
-    // Calculate size based on health and spawn effect
-    float healthScale = 0.8f + (enemy.hitPoints / 3.0f) * 0.2f; // 0.8-1.0 scale
+  switch (preparedBackend)
+  {
+  case CollisionBackend::Grid:
+    colliderGrid.queryBox(minX, minY, maxX, maxY, visit);
+    break;
+  case CollisionBackend::SweepAndPrune:
+    colliderSweep.queryBox(minX, minY, maxX, maxY, visit);
+    break;
+  default:
+    visit(BoxSpan{ c.minX.data(), c.minY.data(), c.maxX.data(), c.maxY.data(), c.indices.data(), c.indices.size() });
+    break;
+  }
+  return count;
+}
 
-    // Add spawn effect - enemies grow from small to normal size over 0.5 seconds
-    float spawnScale = 1.0f;
-    if (enemy.spawnEffect < 0.5f)
+size_t EnemyManager::sweepColliders(float x, float y, float velX, float velY, float duration, float radius,
+  float* hitTime)
+{
+  const ColliderSnapshot& c = colliders;
+  duration = std::min(duration, colliderDeltaTime);
+  float startX = x - velX * duration;
+  float startY = y - velY * duration;
+
+  // Bounds of the path grown by the radius: enemies whose swept box misses them cannot be hit
+  float pathMinX = std::min(startX, x) - radius, pathMaxX = std::max(startX, x) + radius;
+  float pathMinY = std::min(startY, y) - radius, pathMaxY = std::max(startY, y) + radius;
+
+  // Earliest hit along the path; t runs from 0 (duration ago) to 1 (now) for both bodies.
+  // Ties go to the lower snapshot row, so the result does not depend on visiting order.
+  size_t best = SIZE_MAX;
+  float bestTime = 2.0f;
+  auto visit = [&](const BoxSpan& boxes, float exit) {
+    for (size_t first = 0; first < boxes.count; first += BoxKernel::BLOCK)
     {
-      spawnScale = enemy.spawnEffect / 0.5f; // 0.0 to 1.0 over 0.5 seconds
+      uint32_t mask = BoxKernel::overlapMask(boxes, first, pathMinX, pathMinY, pathMaxX, pathMaxY);
+      for (; mask; mask &= mask - 1)
+      {
+        uint32_t j = boxes.items[first + std::countr_zero(mask)];
+        float h = c.halfSize[j];
+        if (h < 0.0f)
+          continue; // Killed earlier this frame
+
+        // Projectile centre relative to the enemy, which moved too, against the box at the
+        // origin grown by the projectile's radius (square corners, slightly generous there)
+        h += radius;
+        float fromX = startX - (c.x[j] - c.velX[j] * duration);
+        float fromY = startY - (c.y[j] - c.velY[j] * duration);
+        float enter, leave;
+        if (segmentBoxOverlap(fromX, fromY, x - c.x[j], y - c.y[j], -h, -h, h, h, enter, leave) &&
+          (enter < bestTime || (enter == bestTime && j < best)))
+        {
+          best = j;
+          bestTime = enter;
+        }
+      }
     }
+    // Cells further along start after exit, so they cannot hold anything earlier
+    return bestTime > exit;
+  };
 
-    float size = 0.15f * enemy.size * healthScale * spawnScale;
+  switch (preparedBackend)
+  {
+  case CollisionBackend::Grid:
+    colliderGrid.querySegment(startX, startY, x, y, visit);
+    break;
+  case CollisionBackend::SweepAndPrune:
+    colliderSweep.querySegment(startX, startY, x, y, visit);
+    break;
+  default:
+    visit(BoxSpan{ c.minX.data(), c.minY.data(), c.maxX.data(), c.maxY.data(), c.indices.data(), c.indices.size() }, 1.0f);
+    break;
+  }
+  if (hitTime)
+    *hitTime = bestTime;
+  return best;
+}
 
-    // Update vertex buffer with new texture coordinates and size
-    float enemyVertices[] = {
-      // positions                          // texture coords
-       size,  size, 0.0f,  frameCoords[0], frameCoords[1],  // top right
-       size, -size, 0.0f,  frameCoords[2], frameCoords[3],  // bottom right
-      -size, -size, 0.0f,  frameCoords[4], frameCoords[5],  // bottom left
-      -size,  size, 0.0f,  frameCoords[6], frameCoords[7]   // top left
-    };
+void EnemyManager::render(std::shared_ptr<Shader> shader)
+{
+  PROFILE_ZONE("Enemy render");
+  size_t count = getEnemyCount();
+  if (count == 0) return;
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(enemyVertices), enemyVertices);
+  shader->use();
 
-    // Create transformation matrix for position
-    float transform[16];
-    for (int i = 0; i < 16; i++)
-      transform[i] = 0.0f;
+  // Gather position, size and frame per enemy; the instances are built from them in one batch
+  InstanceScratch& scratch = renderScratch;
+  scratch.xy.resize(count * 2);
+  scratch.sizes.resize(count);
+  scratch.frames.resize(count);
+  size_t written = 0;
+  world.forEachChunk<Position, Age, SpriteAnimation, Health, EnemyBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const Age* age = chunk.get<Age>();
+    const SpriteAnimation* sprite = chunk.get<SpriteAnimation>();
+    const Health* health = chunk.get<Health>();
+    const EnemyBody* body = chunk.get<EnemyBody>();
+
+    for (size_t i = 0, n = chunk.size(); i < n; i++, written++)
+    {
+      // Calculate size based on health and spawn effect
+      float healthScale = 0.8f + (health[i].hitPoints / 3.0f) * 0.2f; // 0.8-1.0 scale
+
+      // Add spawn effect - enemies grow from small to normal size over 0.5 seconds
+      float spawnScale = 1.0f;
+      if (age[i].seconds < 0.5f)
+      {
+        spawnScale = age[i].seconds / 0.5f; // 0.0 to 1.0 over 0.5 seconds
+      }
 
-    // Identity rotation with translation
-    transform[0] = 1.0f;  transform[5] = 1.0f;  transform[10] = 1.0f; transform[15] = 1.0f;
-    transform[12] = enemy.x; transform[13] = enemy.y;
+      scratch.xy[written * 2] = position[i].x;
+      scratch.xy[written * 2 + 1] = position[i].y;
+      scratch.sizes[written] = 0.15f * body[i].size * healthScale * spawnScale;
+      scratch.frames[written] = sprite[i].frame;
+    }
+  });
 
-    shader->setMatrix4fv("transform", transform);
+  scratch.instances.resize(written);
+  buildSpriteInstances(Mat4::identity(), scratch.xy.data(), scratch.sizes.data(), scratch.frames.data(),
+    &DinoSpriteSheet::frame(0), scratch.instances.data(), written);
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  if (written > instanceCapacity)
+  {
+    // Grow geometrically so steady-state frames only do a sub-data upload
+    instanceCapacity = std::max(written, instanceCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
   }
+  glBufferSubData(GL_ARRAY_BUFFER, 0, written * sizeof(SpriteInstance), scratch.instances.data());
+
+  // Bind enemy texture
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  TextureSampler::bind(samplerProfile, 0);
+  TextureLoader::applyBlendFunc(texture);
+  shader->setInt("ourTexture", 0);
+
+  // All enemies in one draw call, in iteration order like the per-enemy draws were
+  glBindVertexArray(VAO);
+  glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)written);
 }
 
 void EnemyManager::clear()
 {
-  enemies.clear();
+  world.destroyAll<EnemyBody>();
   spawnTimer = 0.0f;
 }
\ No newline at end of file
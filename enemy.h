@@ -2,86 +2,241 @@
 
 #include <vector>
 #include <memory>
-#include <random>
+#include "texture_sampler.h"
+#include "sprite_sheet.h"
+#include "transform_math.h"
+#include "ecs.h"
+#include "components.h"
+#include "rng.h"
+#include "spatial_grid.h"
+#include "sweep_and_prune.h"
+#include "flow_field.h"
+#include "crowd.h"
+#include "kd_tree.h"
 
 class Shader;
 
-struct Enemy {
-  float x, y;              // Position
-  float velX, velY;        // Velocity
-  float life;              // Time alive
-  int frame;               // Current animation frame (0-23)
-  int hitPoints;           // Health (starts at 3)
-  float size;              // Size multiplier
-  bool isAlive;            // Is enemy still alive
-  float spawnEffect;       // Spawn animation timer (0.0 = just spawned)
+// Enemies are World entities with Position, Velocity, Age, SpriteAnimation, Health,
+// ScreenWrap, FlowSteering and EnemyBody; movement, aging, animation and wrapping run as
+// shared systems
+using EnemyHandle = Entity;
 
-  Enemy(float startX, float startY, float vx = 0.0f, float vy = 0.0f);
-
-  // Take damage and return true if enemy dies
-  bool takeDamage(int damage = 1);
+// Where spawnBurst places enemies
+enum class SpawnPattern {
+  ScreenArea,   // Visible square minus the box around the player (where single spawns go)
+  Ring          // Annulus around the player
+};
 
-  // Check if point is inside enemy (for collision detection)
-  bool containsPoint(float pointX, float pointY) const;
+// Broadphase that finds the enemies a projectile's path may touch
+enum class CollisionBackend {
+  Grid,            // Uniform grid, walked cell by cell along the path
+  SweepAndPrune,   // Boxes sorted along x, re-sorted incrementally every frame
+  BruteForce       // Every enemy (reference)
 };
 
+const char* getCollisionBackendName(CollisionBackend backend);
+
 class EnemyManager
 {
 public:
-  EnemyManager();
+  explicit EnemyManager(World& world);
   ~EnemyManager();
 
   // Initialize OpenGL resources
   bool initialize(const char* texturePath);
 
-  // Update all enemies
+  // Initialize OpenGL resources with an already acquired texture (takes over that reference)
+  bool initializeWithTexture(unsigned int textureID);
+
+  // Per-frame enemy logic (spawning, then steering along the flow field toward the target
+  // and around nearby enemies); movement and animation run as shared systems
   void update(float deltaTime);
 
+  // What enemies chase (the llama); the flow field is rebuilt when it moves to another cell
+  void setTarget(float x, float y) { flowField.setTarget(x, y); }
+
+  // Obstacles live on the flow field
+  FlowField& getFlowField() { return flowField; }
+
+  // Separation, alignment and cohesion between nearby enemies, after flow steering
+  void setCrowdSteering(bool enabled) { crowdSteering = enabled; }
+  bool getCrowdSteering() const { return crowdSteering; }
+  Crowd& getCrowd() { return crowd; }
+
+  // Push overlapping enemies apart (their collision boxes), after movement; a no-op when off
+  void resolveOverlaps();
+  void setOverlapResolution(bool enabled) { overlapResolution = enabled; }
+  bool getOverlapResolution() const { return overlapResolution; }
+
   // Render all enemies
   void render(std::shared_ptr<Shader> shader);
 
-  // Spawn management
+  // Spawn management (trySpawnEnemy spawns every enemy that came due this frame)
   void trySpawnEnemy(float deltaTime);
-  void spawnEnemyAtRandomLocation();
+  EnemyHandle spawnEnemyAtRandomLocation();
+  EnemyHandle spawnEnemy(float x, float y, float velX, float velY);
 
-  // Collision detection with projectiles
-  bool checkProjectileCollisions(float projX, float projY, float projRadius = 0.08f);
+  // Spawn up to count enemies at once (capped by the max enemy count): positions are sampled
+  // directly in the pattern's region and the batch is written chunk by chunk. Returns how many
+  // were spawned.
+  size_t spawnBurst(size_t count, SpawnPattern pattern = SpawnPattern::ScreenArea);
 
-  // Get enemy count
-  size_t getEnemyCount() const { return enemies.size(); }
-  size_t getAliveEnemyCount() const;
+  // Collision detection with projectiles: damages the first enemy whose box the circle of
+  // projRadius around the point touches, and destroys it when its hit points run out. Must
+  // not be called while iterating enemies.
+  bool checkProjectileCollisions(float projX, float projY, float projRadius = 0.08f);
 
-  // Clear all enemies
+  // Continuous collision, for any frame length without substeps. prepareCollision snapshots
+  // the enemies after movement: each box swept back over deltaTime along its velocity and
+  // grown by reach goes into the broadphase. sweepProjectile then takes a projectile of the
+  // given radius (at most reach) that is at (x, y) now after moving at (velX, velY) for
+  // duration seconds (at most deltaTime), finds the enemy it reached first with both moving,
+  // and damages it like checkProjectileCollisions.
+  void prepareCollision(float deltaTime, float reach = 0.0f);
+  bool sweepProjectile(float x, float y, float velX, float velY, float duration, float radius = 0.0f);
+
+  // The enemy sweepProjectile would damage, without damaging it; null if the path is clear
+  EnemyHandle findFirstHit(float x, float y, float velX, float velY, float duration, float radius = 0.0f);
+
+  // sweepProjectile for an explosive shot: where the path first hits an enemy it explodes,
+  // with damageArea of blastRadius around that point
+  bool sweepExplosive(float x, float y, float velX, float velY, float duration, float radius, float blastRadius,
+    int damage);
+
+  // Range queries over the prepareCollision snapshot (killed enemies left out): the enemies
+  // whose box the circle touches, or the capsule of radius around the segment (x0, y0) ->
+  // (x1, y1). Each enemy is written once, up to capacity; returns how many were written.
+  // They only fill the caller's buffer, nothing is allocated.
+  size_t queryCircle(float x, float y, float radius, EnemyHandle* outEnemies, size_t capacity);
+  size_t queryCapsule(float x0, float y0, float x1, float y1, float radius, EnemyHandle* outEnemies,
+    size_t capacity);
+
+  // Area damage after prepareCollision: every enemy within radius of (x, y) loses damage hit
+  // points scaled by 1 - distance / radius (rounded up; distance to its box) and is destroyed
+  // when they run out. Returns how many enemies were damaged.
+  size_t damageArea(float x, float y, float radius, int damage);
+
+  // Nearest-enemy lookups (homing projectiles). prepareTargeting snapshots the live enemies'
+  // positions into a k-d tree, refit to the new positions while no enemy was spawned since it
+  // was built and rebuilt otherwise (and every few calls); findNearestEnemies then answers
+  // count queries at once on the job pool, writing a null handle where there are no enemies.
+  void prepareTargeting();
+  void findNearestEnemies(const float* xs, const float* ys, size_t count, EnemyHandle* outEnemies);
+
+  // Takes effect at the next prepareCollision
+  void setCollisionBackend(CollisionBackend backend) { collisionBackend = backend; }
+  CollisionBackend getCollisionBackend() const { return collisionBackend; }
+
+  // Insertion sort swaps of the last sweep and prune update (0 for other backends)
+  size_t getLastSweepSwapCount() const { return preparedBackend == CollisionBackend::SweepAndPrune ? colliderSweep.getLastSwapCount() : 0; }
+
+  // Get enemy count (killed enemies are destroyed immediately, so every enemy is alive)
+  size_t getEnemyCount() const { return world.count<EnemyBody>(); }
+  size_t getAliveEnemyCount() const { return getEnemyCount(); }
+
+  // Whether a handle still refers to a live enemy; read its components through the World
+  bool isAlive(EnemyHandle handle) const { return world.has<EnemyBody>(handle); }
+
+  // Destroy all enemies
   void clear();
 
   // Configuration
   void setMaxEnemies(int max) { maxEnemies = max; }
   void setSpawnRate(float rate) { spawnRate = rate; } // enemies per second
 
+  // Filtering used when sampling the texture
+  void setSamplerProfile(SamplerProfile profile);
+  SamplerProfile getSamplerProfile() const { return samplerProfile; }
+
 private:
-  std::vector<Enemy> enemies;
+  World& world;
 
   // Spawn settings
   int maxEnemies;
   float spawnRate;           // enemies per second
   float spawnTimer;
 
-  // Random number generation
-  mutable std::random_device rd;
-  mutable std::mt19937 gen;
-  mutable std::uniform_real_distribution<float> posDis;      // For spawn positions
-  mutable std::uniform_real_distribution<float> speedDis;    // For movement speed
-
-  // OpenGL resources
+  // Random number generation (the "enemies" stream of the global seed)
+  Rng rng;
+
+  // Per-burst scratch columns, kept to avoid reallocating
+  std::vector<float> burstScratch;
+
+  // Enemies as of prepareCollision (SoA); killed ones get halfSize -1
+  struct ColliderSnapshot {
+    std::vector<Entity> entities;
+    std::vector<uint32_t> keys;   // Entity slot index, stable across frames
+    std::vector<uint32_t> indices;   // 0..n-1, the brute-force candidate list
+    std::vector<float> x, y, velX, velY, halfSize;
+    std::vector<float> minX, minY, maxX, maxY;   // Box swept over the frame, grown by reach
+  } colliders;
+  float colliderDeltaTime;
+  CollisionBackend collisionBackend;
+  CollisionBackend preparedBackend;   // The one the snapshot was built for
+  SpatialGrid colliderGrid;
+  SweepAndPrune colliderSweep;
+
+  // Range query scratch, sized by prepareCollision: a row is taken when its mark equals the
+  // query's stamp, so rows listed in several grid cells are reported once
+  std::vector<uint32_t> rangeMarks;
+  uint32_t rangeStamp;
+  std::vector<uint32_t> rangeRows;   // Rows found by the last query
+
+  // OpenGL resources: a unit quad, and one SpriteInstance per enemy drawn instanced
   unsigned int VAO, VBO, EBO;
+  unsigned int instanceVBO;
+  size_t instanceCapacity;            // In enemies
   unsigned int texture;
+  SamplerProfile samplerProfile;
+
+  // Render scratch, gathered per enemy before the instances are built in one batch
+  struct InstanceScratch {
+    std::vector<float> xy, sizes;
+    std::vector<int> frames;
+    std::vector<SpriteInstance> instances;
+  } renderScratch;
 
   // Helper functions
   void setupMesh();
   unsigned int loadTexture(const char* path);
-  void getFrameCoords(int frame, float coords[8]);
-  void removeDeadEnemies();
 
   // Spawn position calculation
   void getRandomSpawnPosition(float& x, float& y);
+
+  // Pathing toward the target
+  FlowField flowField;
+  void steerAlongFlowField(float deltaTime);
+
+  // Workers for the parallel passes (crowd steering and overlaps, nearest-enemy batches)
+  JobPool jobs;
+
+  // Local avoidance over a per-frame SoA copy of the enemies
+  Crowd crowd;
+  bool crowdSteering;
+  bool overlapResolution;
+  struct CrowdScratch {
+    std::vector<float> x, y, velX, velY, outVelX, outVelY, halfSize;
+  } crowdScratch;
+  void steerAroundNeighbours(float deltaTime);
+
+  // Enemies as of prepareTargeting by entity slot (tree items); empty slots are infinite
+  struct TargetSnapshot {
+    std::vector<Entity> entities;
+    std::vector<float> x, y;
+    std::vector<uint32_t> items;   // findNearestEnemies scratch
+    int refits = 0;                // Since the last build
+  } targets;
+  KdTree targetTree;
+
+  // Snapshot row of the first enemy hit along a projectile path, SIZE_MAX if none; hitTime
+  // gets the fraction of the path travelled before the hit
+  size_t sweepColliders(float x, float y, float velX, float velY, float duration, float radius,
+    float* hitTime = nullptr);
+
+  // Snapshot rows in the capsule (a circle when the segment is a point) into rangeRows, up to
+  // capacity; returns how many
+  size_t collectInRange(float x0, float y0, float x1, float y1, float radius, size_t capacity);
+
+  // Takes damage hit points from a snapshot row's enemy, destroying it when they run out
+  void damageCollider(size_t row, int damage);
 };
\ No newline at end of file
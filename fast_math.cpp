@@ -0,0 +1,97 @@
+#include "fast_math.h"
+#include "transform_math.h"   // LLAMA_MATH_SSE
+
+#if LLAMA_MATH_SSE
+#include <emmintrin.h>
+
+namespace
+{
+  // mask ? a : b
+  inline __m128 select(__m128 mask, __m128 a, __m128 b)
+  {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+}
+#endif
+
+namespace FastMath
+{
+  void sinCos(const float* angles, float* sines, float* cosines, size_t count)
+  {
+    size_t i = 0;
+#if LLAMA_MATH_SSE
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    const __m128 signBit = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 x = _mm_loadu_ps(angles + i);
+
+      // Round to nearest like lrint (default MXCSR rounding)
+      __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+      __m128 k = _mm_cvtepi32_ps(quadrant);
+      __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(HALF_PI_PART1)));
+      r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(HALF_PI_PART2)));
+      r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(HALF_PI_PART3)));
+      __m128 r2 = _mm_mul_ps(r, r);
+
+      __m128 sinPoly = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)));
+      sinPoly = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(r2, sinPoly));
+      __m128 sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinPoly));
+
+      __m128 cosPoly = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)));
+      cosPoly = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(r2, cosPoly));
+      __m128 cosR = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+        _mm_mul_ps(_mm_mul_ps(r2, r2), cosPoly));
+
+      // Odd quadrants swap sin and cos; quadrants 2-3 negate sin, 1-2 negate cos
+      __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+      __m128 s = select(swap, cosR, sinR);
+      __m128 c = select(swap, sinR, cosR);
+      __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+      __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+      _mm_storeu_ps(sines + i, _mm_xor_ps(s, _mm_and_ps(sinSign, signBit)));
+      _mm_storeu_ps(cosines + i, _mm_xor_ps(c, _mm_and_ps(cosSign, signBit)));
+    }
+#endif
+    for (; i < count; i++)
+      sinCos(angles[i], sines[i], cosines[i]);
+  }
+
+  void atan2(const float* ys, const float* xs, float* out, size_t count)
+  {
+    size_t i = 0;
+#if LLAMA_MATH_SSE
+    const __m128 signBit = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 y = _mm_loadu_ps(ys + i);
+      __m128 x = _mm_loadu_ps(xs + i);
+      __m128 ax = _mm_andnot_ps(signBit, x);
+      __m128 ay = _mm_andnot_ps(signBit, y);
+      __m128 hi = _mm_max_ps(ax, ay);
+      __m128 lo = _mm_min_ps(ax, ay);
+
+      // 0 / 0 gives NaN; those lanes become 0
+      __m128 a = _mm_and_ps(_mm_cmpgt_ps(hi, zero), _mm_div_ps(lo, hi));
+
+      __m128 fold = _mm_cmpgt_ps(a, _mm_set1_ps(TAN_PI_8));
+      a = select(fold, _mm_div_ps(_mm_sub_ps(a, one), _mm_add_ps(a, one)), a);
+      __m128 offset = _mm_and_ps(fold, _mm_set1_ps(QUARTER_PI));
+
+      __m128 z = _mm_mul_ps(a, a);
+      __m128 poly = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(8.05374449538e-2f), z), _mm_set1_ps(1.38776856032e-1f));
+      poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(1.99777106478e-1f));
+      poly = _mm_sub_ps(_mm_mul_ps(poly, z), _mm_set1_ps(3.33329491539e-1f));
+      __m128 r = _mm_add_ps(_mm_add_ps(offset, a), _mm_mul_ps(_mm_mul_ps(a, z), poly));
+
+      r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HALF_PI), r), r);
+      r = select(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+      r = select(_mm_cmplt_ps(y, zero), _mm_xor_ps(r, signBit), r);
+      _mm_storeu_ps(out + i, r);
+    }
+#endif
+    for (; i < count; i++)
+      out[i] = atan2(ys[i], xs[i]);
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// Float trigonometry for gameplay code: polynomial approximations (Cephes sinf/cosf/atanf
+// coefficients) with the same results from the scalar inline versions and the SSE batch
+// versions. Measured against double-precision libm (see the "fast_math" benchmark):
+//   sinCos  max abs error 9.3e-8 for |x| <= 1e4 (float Cody-Waite range reduction stays
+//           exact up to |x| ~ 1e5 and degrades beyond that)
+//   atan2   max abs error 2.9e-7 rad for any finite input; atan2(0, 0) = 0 and the sign
+//           of zero is ignored (atan2(-0, -1) = +pi)
+namespace FastMath
+{
+  const float PI = 3.14159265358979323846f;
+  const float HALF_PI = 1.57079632679489661923f;
+  const float QUARTER_PI = 0.78539816339744830962f;
+  const float TWO_OVER_PI = 0.63661977236758134308f;
+
+  // pi/2 split so k * part is exact for moderate k
+  const float HALF_PI_PART1 = 1.5703125f;
+  const float HALF_PI_PART2 = 4.837512969970703125e-4f;
+  const float HALF_PI_PART3 = 7.54978995489188216e-8f;
+
+  const float TAN_PI_8 = 0.41421356237309504880f;
+
+  inline void sinCos(float x, float& s, float& c)
+  {
+    // Reduce to r in [-pi/4, pi/4] and a quadrant
+    int quadrant = (int)std::lrint(x * TWO_OVER_PI);
+    float k = (float)quadrant;
+    float r = ((x - k * HALF_PI_PART1) - k * HALF_PI_PART2) - k * HALF_PI_PART3;
+    float r2 = r * r;
+
+    float sinR = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float cosR = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    switch (quadrant & 3)
+    {
+    case 0: s = sinR; c = cosR; break;
+    case 1: s = cosR; c = -sinR; break;
+    case 2: s = -sinR; c = -cosR; break;
+    default: s = -cosR; c = sinR; break;
+    }
+  }
+
+  inline float sin(float x) { float s, c; sinCos(x, s, c); return s; }
+  inline float cos(float x) { float s, c; sinCos(x, s, c); return c; }
+
+  inline float atan2(float y, float x)
+  {
+    // atan of min/max in [0, 1], folded back into the right octant
+    float ax = std::fabs(x), ay = std::fabs(y);
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    float a = hi > 0.0f ? lo / hi : 0.0f;
+
+    float offset = 0.0f;
+    if (a > TAN_PI_8)
+    {
+      a = (a - 1.0f) / (a + 1.0f);
+      offset = QUARTER_PI;
+    }
+    float z = a * a;
+    float r = offset + a + a * z * (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f);
+
+    if (ay > ax) r = HALF_PI - r;
+    if (x < 0.0f) r = PI - r;
+    return y < 0.0f ? -r : r;
+  }
+
+  // Batch versions (SSE2 when available); outputs may not alias the inputs
+  void sinCos(const float* angles, float* sines, float* cosines, size_t count);
+  void atan2(const float* ys, const float* xs, float* out, size_t count);
+}
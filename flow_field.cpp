@@ -0,0 +1,226 @@
+#include "flow_field.h"
+#include "profiler.h"
+#include "transform_math.h"   // LLAMA_MATH_SSE
+
+#include <cmath>
+#include <functional>
+#include <queue>
+
+#if LLAMA_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+  const float UNREACHABLE = INFINITY;
+  const float DIAGONAL_COST = 1.41421356f;
+
+  const int STEP_X[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+  const int STEP_Y[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+}
+
+FlowField::FlowField(float extent, float cellSize)
+  : extent(extent), cellSize(cellSize), inverseCellSize(1.0f / cellSize),
+  columns(std::max((int)std::ceil(2.0f * extent / cellSize), 1))
+{
+  size_t cells = (size_t)columns * columns;
+  blocked.assign(cells, 0);
+  cost.assign(cells, UNREACHABLE);
+  directions.assign(cells * 2, 0.0f);
+}
+
+void FlowField::setTarget(float x, float y)
+{
+  size_t cell = cellAt(x, y);
+  int column = (int)(cell % columns), row = (int)(cell / columns);
+  if (column != targetColumn || row != targetRow)
+  {
+    targetColumn = column;
+    targetRow = row;
+    dirty = true;
+  }
+}
+
+void FlowField::setBlocked(float minX, float minY, float maxX, float maxY, bool block)
+{
+  size_t first = cellAt(minX, minY), last = cellAt(maxX, maxY);
+  for (size_t row = first / columns; row <= last / columns; row++)
+  {
+    for (size_t column = first % columns; column <= last % columns; column++)
+      blocked[row * columns + column] = block ? 1 : 0;
+  }
+  dirty = true;
+}
+
+void FlowField::clearObstacles()
+{
+  std::fill(blocked.begin(), blocked.end(), 0);
+  dirty = true;
+}
+
+bool FlowField::update()
+{
+  if (!dirty)
+    return false;
+
+  PROFILE_ZONE("Flow field");
+  computeCosts();
+  computeDirections();
+  dirty = false;
+  return true;
+}
+
+void FlowField::steer(const float* positions, float* velocities, const float* steering, size_t count, float deltaTime) const
+{
+  size_t i = 0;
+#if LLAMA_MATH_SSE
+  // Two agents per register: (x0, y0, x1, y1)
+  const __m128 offset = _mm_set1_ps(extent);
+  const __m128 scale = _mm_set1_ps(inverseCellSize);
+  const __m128 last = _mm_set1_ps((float)(columns - 1));
+  const __m128 stride = _mm_setr_ps(1.0f, (float)columns, 1.0f, (float)columns);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 time = _mm_set1_ps(deltaTime);
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128 position = _mm_loadu_ps(positions + i * 2);
+    __m128 cell = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_add_ps(position, offset), scale), _mm_setzero_ps()), last);
+
+    // column + row * columns for both agents, exact in float for any grid that fits in memory
+    __m128 weighted = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(cell)), stride);
+    __m128i index = _mm_cvttps_epi32(_mm_add_ps(weighted, _mm_shuffle_ps(weighted, weighted, _MM_SHUFFLE(2, 3, 0, 1))));
+    int first = _mm_cvtsi128_si32(index);
+    int second = _mm_cvtsi128_si32(_mm_shuffle_epi32(index, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m128 direction = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&directions[(size_t)first * 2]),
+      (const __m64*)&directions[(size_t)second * 2]);
+
+    // (speed0, rate0, speed1, rate1) -> speeds and blend factors per lane
+    __m128 pair = _mm_loadu_ps(steering + i * 2);
+    __m128 speed = _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 blend = _mm_min_ps(_mm_mul_ps(_mm_shuffle_ps(pair, pair, _MM_SHUFFLE(3, 3, 1, 1)), time), one);
+
+    __m128 velocity = _mm_loadu_ps(velocities + i * 2);
+    velocity = _mm_add_ps(velocity, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(direction, speed), velocity), blend));
+    _mm_storeu_ps(velocities + i * 2, velocity);
+  }
+#endif
+  for (; i < count; i++)
+  {
+    float dirX, dirY;
+    sample(positions[i * 2], positions[i * 2 + 1], dirX, dirY);
+    float blend = std::min(steering[i * 2 + 1] * deltaTime, 1.0f);
+    velocities[i * 2] += (dirX * steering[i * 2] - velocities[i * 2]) * blend;
+    velocities[i * 2 + 1] += (dirY * steering[i * 2] - velocities[i * 2 + 1]) * blend;
+  }
+}
+
+bool FlowField::canStep(int column, int row, int dx, int dy) const
+{
+  int toColumn = column + dx, toRow = row + dy;
+  if (toColumn < 0 || toColumn >= columns || toRow < 0 || toRow >= columns)
+    return false;
+  if (blocked[(size_t)toRow * columns + toColumn])
+    return false;
+
+  // Diagonals need both orthogonal neighbours open
+  return dx == 0 || dy == 0 ||
+    (!blocked[(size_t)row * columns + toColumn] && !blocked[(size_t)toRow * columns + column]);
+}
+
+void FlowField::computeCosts()
+{
+  std::fill(cost.begin(), cost.end(), UNREACHABLE);
+  size_t target = (size_t)targetRow * columns + targetColumn;
+  if (blocked[target])
+    return;
+
+  using Entry = std::pair<float, uint32_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  cost[target] = 0.0f;
+  open.push(Entry{ 0.0f, (uint32_t)target });
+  while (!open.empty())
+  {
+    Entry entry = open.top();
+    open.pop();
+    uint32_t cell = entry.second;
+    if (entry.first > cost[cell])
+      continue; // Stale
+
+    int column = (int)(cell % columns), row = (int)(cell / columns);
+    for (int k = 0; k < 8; k++)
+    {
+      if (!canStep(column, row, STEP_X[k], STEP_Y[k]))
+        continue;
+      size_t next = (size_t)(row + STEP_Y[k]) * columns + column + STEP_X[k];
+      float nextCost = entry.first + (k < 4 ? 1.0f : DIAGONAL_COST);
+      if (nextCost < cost[next])
+      {
+        cost[next] = nextCost;
+        open.push(Entry{ nextCost, (uint32_t)next });
+      }
+    }
+  }
+}
+
+void FlowField::computeDirections()
+{
+  for (int row = 0; row < columns; row++)
+  {
+    for (int column = 0; column < columns; column++)
+    {
+      size_t cell = (size_t)row * columns + column;
+      float here = cost[cell];
+      float dirX = 0.0f, dirY = 0.0f;
+      if (here != UNREACHABLE && here > 0.0f)
+      {
+        // Central differences where all four sides are open give smooth headings; the field
+        // edge counts as open and takes this cell's cost
+        bool open = true;
+        float side[4];
+        for (int k = 0; k < 4; k++)
+        {
+          int toColumn = column + STEP_X[k], toRow = row + STEP_Y[k];
+          if (toColumn < 0 || toColumn >= columns || toRow < 0 || toRow >= columns)
+          {
+            side[k] = here;
+            continue;
+          }
+          side[k] = cost[(size_t)toRow * columns + toColumn];
+          open = open && side[k] != UNREACHABLE;
+        }
+        if (open)
+        {
+          dirX = side[1] - side[0];
+          dirY = side[3] - side[2];
+        }
+
+        // Next to obstacles (or on a flat spot), head for the cheapest neighbour instead
+        if (!open || (dirX == 0.0f && dirY == 0.0f))
+        {
+          float best = here;
+          for (int k = 0; k < 8; k++)
+          {
+            if (!canStep(column, row, STEP_X[k], STEP_Y[k]))
+              continue;
+            float next = cost[(size_t)(row + STEP_Y[k]) * columns + column + STEP_X[k]];
+            if (next < best)
+            {
+              best = next;
+              dirX = (float)STEP_X[k];
+              dirY = (float)STEP_Y[k];
+            }
+          }
+        }
+
+        float length = std::sqrt(dirX * dirX + dirY * dirY);
+        if (length > 0.0f)
+        {
+          dirX /= length;
+          dirY /= length;
+        }
+      }
+      directions[cell * 2] = dirX;
+      directions[cell * 2 + 1] = dirY;
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Directions toward a target over a uniform grid, for any number of agents to follow at O(1)
+// each. A Dijkstra pass (8-connected, never cutting past a blocked corner) gives every cell
+// its path cost from the target's cell; each cell then points down the cost gradient, or at
+// its cheapest neighbour next to obstacles. The pass only reruns when the target moves to
+// another cell or obstacles change, so a resting or slowly moving target costs nothing.
+class FlowField
+{
+public:
+  // Covers the [-extent, extent] square
+  explicit FlowField(float extent = 5.0f, float cellSize = 0.1f);
+
+  void setTarget(float x, float y);
+
+  // Block (or unblock) every cell overlapping the box
+  void setBlocked(float minX, float minY, float maxX, float maxY, bool block);
+  void clearObstacles();
+
+  // Recompute costs and directions if the target cell or obstacles changed; true if it did
+  bool update();
+
+  // Unit direction toward the target; (0, 0) in the target's cell, in blocked cells and where
+  // the target is unreachable. Positions outside the field use the nearest edge cell.
+  void sample(float x, float y, float& dirX, float& dirY) const
+  {
+    const float* direction = &directions[cellAt(x, y) * 2];
+    dirX = direction[0];
+    dirY = direction[1];
+  }
+
+  // Steer count agents: each velocity moves toward direction * speed by turnRate * deltaTime
+  // of the difference (at most all of it). positions and velocities are packed (x, y) pairs,
+  // steering packed (speed, turnRate) pairs.
+  void steer(const float* positions, float* velocities, const float* steering, size_t count, float deltaTime) const;
+
+  int getColumns() const { return columns; }
+  float getCellSize() const { return cellSize; }
+
+private:
+  float extent;
+  float cellSize;
+  float inverseCellSize;
+  int columns;   // Square grid: columns x columns
+
+  std::vector<uint8_t> blocked;
+  std::vector<float> cost;
+  std::vector<float> directions;   // (x, y) per cell, interleaved so a sample is one load
+
+  int targetColumn = 0, targetRow = 0;
+  bool dirty = true;
+
+  // Clamped in float before truncating, which keeps the per-agent path branch-free
+  size_t cellAt(float x, float y) const
+  {
+    float last = (float)(columns - 1);
+    int column = (int)std::min(std::max((x + extent) * inverseCellSize, 0.0f), last);
+    int row = (int)std::min(std::max((y + extent) * inverseCellSize, 0.0f), last);
+    return (size_t)row * columns + column;
+  }
+
+  // Whether a step from (column, row) by (dx, dy) stays in the field and never crosses a blocked cell
+  bool canStep(int column, int row, int dx, int dy) const;
+
+  void computeCosts();
+  void computeDirections();
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ecs.h"
+
+// Systems shared by every entity kind that has the components they query. Register them
+// with a SystemScheduler; kind-specific logic (spawning, collisions, rendering) stays in
+// the managers.
+namespace GameSystems
+{
+  // Position += Velocity * dt
+  void movement(World& world, float deltaTime);
+
+  // Age += dt
+  void aging(World& world, float deltaTime);
+
+  // SpriteAnimation frame from Age
+  void animation(World& world, float deltaTime);
+
+  // Wrap Position around ScreenWrap bounds
+  void screenWrap(World& world, float deltaTime);
+
+  // movement, aging, animation and screenWrap in one walk over the chunks, in that order
+  // per chunk; same result as running the four in turn
+  void integrate(World& world, float deltaTime);
+
+  // Destroy entities past their Expiry
+  void expiry(World& world, float deltaTime);
+}
@@ -0,0 +1,90 @@
+#include "job_pool.h"
+#include "profiler.h"
+
+#include <algorithm>
+
+JobPool::JobPool(unsigned int threadCount)
+  : stopping(false), task(nullptr), taskCount(0), taskBlockSize(1), nextBlock(0), generation(0), busyWorkers(0)
+{
+  if (threadCount == 0)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+  for (unsigned int i = 1; i < threadCount; i++)
+    workers.emplace_back(&JobPool::workerLoop, this);
+}
+
+JobPool::~JobPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeSignal.notify_all();
+
+  for (auto& worker : workers)
+    worker.join();
+}
+
+void JobPool::parallelFor(size_t count, size_t blockSize, const std::function<void(size_t, size_t)>& fn)
+{
+  blockSize = std::max(blockSize, (size_t)1);
+  if (workers.empty() || count <= blockSize)
+  {
+    // Not worth waking anyone
+    for (size_t begin = 0; begin < count; begin += blockSize)
+      fn(begin, std::min(begin + blockSize, count));
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &fn;
+    taskCount = count;
+    taskBlockSize = blockSize;
+    nextBlock = 0;
+    busyWorkers = workers.size();
+    generation++;
+  }
+  wakeSignal.notify_all();
+
+  runBlocks();
+
+  // Workers still inside fn hold a reference to it
+  std::unique_lock<std::mutex> lock(mutex);
+  doneSignal.wait(lock, [this] { return busyWorkers == 0; });
+  task = nullptr;
+}
+
+void JobPool::workerLoop()
+{
+  Profiler::setThreadName("Job worker");
+
+  size_t seen = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeSignal.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+    }
+
+    runBlocks();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--busyWorkers == 0)
+      doneSignal.notify_one();
+  }
+}
+
+void JobPool::runBlocks()
+{
+  while (true)
+  {
+    size_t begin = nextBlock.fetch_add(1) * taskBlockSize;
+    if (begin >= taskCount)
+      return;
+    (*task)(begin, std::min(begin + taskBlockSize, taskCount));
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads for splitting per-frame loops. parallelFor hands out fixed blocks
+// of an index range and returns once all of them ran, with the calling thread taking blocks
+// too. Blocks are fixed by the range and block size alone, so a loop whose blocks write
+// disjoint output gets the same result with any number of threads.
+class JobPool
+{
+public:
+  // threadCount counts the calling thread; 0 picks one per hardware thread
+  explicit JobPool(unsigned int threadCount = 0);
+  ~JobPool();
+
+  JobPool(const JobPool&) = delete;
+  JobPool& operator=(const JobPool&) = delete;
+
+  // Calls fn(begin, end) for each block of [0, count); blocks may run in any order and at once
+  void parallelFor(size_t count, size_t blockSize, const std::function<void(size_t, size_t)>& fn);
+
+  unsigned int getThreadCount() const { return (unsigned int)workers.size() + 1; }
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wakeSignal;
+  std::condition_variable doneSignal;
+  bool stopping;
+
+  // The running loop; set under mutex before generation changes
+  const std::function<void(size_t, size_t)>* task;
+  size_t taskCount;
+  size_t taskBlockSize;
+  std::atomic<size_t> nextBlock;
+  size_t generation;
+  size_t busyWorkers;
+
+  void workerLoop();
+  void runBlocks();
+};
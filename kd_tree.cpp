@@ -0,0 +1,212 @@
+#include "kd_tree.h"
+#include "job_pool.h"
+
+#include <algorithm>
+
+namespace
+{
+  // Queries per parallelFor block
+  const size_t QUERY_BLOCK_SIZE = 256;
+
+  // Deeper than any tree that fits in memory: each level keeps at most one pending far side
+  const int MAX_STACK = 64;
+}
+
+void KdTree::build(const float* xs, const float* ys, size_t count)
+{
+  // Start from the last build's order: keep its items that are still in range and alive, then
+  // append the live ones it did not have. Any order gives a valid tree; a close one saves work.
+  seen.assign(count, 0);
+  size_t kept = 0;
+  for (size_t i = 0, n = points.size(); i < n; i++)
+  {
+    uint32_t item = points[i].item;
+    if (item < count && std::isfinite(xs[item]) && std::isfinite(ys[item]))
+    {
+      points[kept++].item = item;
+      seen[item] = 1;
+    }
+  }
+  points.resize(kept);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!seen[i] && std::isfinite(xs[i]) && std::isfinite(ys[i]))
+      points.push_back(Point{ 0.0f, 0.0f, (uint32_t)i });
+  }
+
+  size_t size = points.size();
+  axes.assign(size, 0);
+  lowerMax.assign(size, 0.0f);
+  upperMin.assign(size, 0.0f);
+  if (size == 0)
+    return;
+
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+  for (Point& point : points)
+  {
+    point.x = xs[point.item];
+    point.y = ys[point.item];
+    minX = std::min(minX, point.x);
+    maxX = std::max(maxX, point.x);
+    minY = std::min(minY, point.y);
+    maxY = std::max(maxY, point.y);
+  }
+  buildRange(0, size, minX, minY, maxX, maxY);
+}
+
+void KdTree::buildRange(size_t first, size_t last, float minX, float minY, float maxX, float maxY)
+{
+  while (last - first > LEAF_SIZE)
+  {
+    // The box is the parent's cut at its split, so it bounds the range without a scan
+    uint8_t axis = maxY - minY > maxX - minX ? 1 : 0;
+    size_t middle = first + (last - first) / 2;
+    if (axis)
+      std::nth_element(points.begin() + first, points.begin() + middle, points.begin() + last,
+        [](const Point& a, const Point& b) { return a.y < b.y; });
+    else
+      std::nth_element(points.begin() + first, points.begin() + middle, points.begin() + last,
+        [](const Point& a, const Point& b) { return a.x < b.x; });
+    axes[middle] = axis;
+    float split = axis ? points[middle].y : points[middle].x;
+    lowerMax[middle] = split;
+    upperMin[middle] = split;
+
+    // Recurse into the smaller half, loop on the other
+    if (middle - first < last - middle - 1)
+    {
+      buildRange(first, middle, minX, minY, axis ? maxX : split, axis ? split : maxY);
+      first = middle + 1;
+      (axis ? minY : minX) = split;
+    }
+    else
+    {
+      buildRange(middle + 1, last, axis ? minX : split, axis ? split : minY, maxX, maxY);
+      last = middle;
+      (axis ? maxY : maxX) = split;
+    }
+  }
+}
+
+void KdTree::refit(const float* xs, const float* ys)
+{
+  for (Point& point : points)
+  {
+    point.x = xs[point.item];
+    point.y = ys[point.item];
+  }
+  if (!points.empty())
+    refitRange(0, points.size());
+}
+
+KdTree::Box KdTree::refitRange(size_t first, size_t last)
+{
+  // Dead points have an infinite coordinate and stay out of the boxes; an empty box is
+  // inverted, so a split with nothing alive on one side prunes that side
+  Box box{ INFINITY, INFINITY, -INFINITY, -INFINITY };
+  auto include = [&box](const Point& point) {
+    if (!std::isfinite(point.x) || !std::isfinite(point.y))
+      return;
+    box.minX = std::min(box.minX, point.x);
+    box.minY = std::min(box.minY, point.y);
+    box.maxX = std::max(box.maxX, point.x);
+    box.maxY = std::max(box.maxY, point.y);
+  };
+
+  if (last - first <= LEAF_SIZE)
+  {
+    for (size_t i = first; i < last; i++)
+      include(points[i]);
+    return box;
+  }
+
+  size_t middle = first + (last - first) / 2;
+  Box lower = refitRange(first, middle);
+  Box upper = refitRange(middle + 1, last);
+  lowerMax[middle] = axes[middle] ? lower.maxY : lower.maxX;
+  upperMin[middle] = axes[middle] ? upper.minY : upper.minX;
+
+  box = Box{ std::min(lower.minX, upper.minX), std::min(lower.minY, upper.minY),
+    std::max(lower.maxX, upper.maxX), std::max(lower.maxY, upper.maxY) };
+  include(points[middle]);
+  return box;
+}
+
+uint32_t KdTree::nearest(float x, float y, float maxDistanceSquared) const
+{
+  struct Range {
+    uint32_t first, last;
+    float boundSquared;   // Squared distance to the split plane that separates it from the query
+  };
+
+  Range stack[MAX_STACK];
+  int depth = 0;
+  stack[depth++] = Range{ 0, (uint32_t)points.size(), 0.0f };
+
+  float best = maxDistanceSquared;
+  uint32_t bestItem = NONE;
+  while (depth > 0)
+  {
+    Range range = stack[--depth];
+    if (range.boundSquared >= best)
+      continue;
+
+    if (range.last - range.first <= LEAF_SIZE)
+    {
+      for (uint32_t i = range.first; i < range.last; i++)
+      {
+        float dx = points[i].x - x, dy = points[i].y - y;
+        float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared < best)
+        {
+          best = distanceSquared;
+          bestItem = points[i].item;
+        }
+      }
+      continue;
+    }
+
+    uint32_t middle = range.first + (range.last - range.first) / 2;
+    const Point& split = points[middle];
+    float dx = split.x - x, dy = split.y - y;
+    float distanceSquared = dx * dx + dy * dy;
+    if (distanceSquared < best)
+    {
+      best = distanceSquared;
+      bestItem = split.item;
+    }
+
+    // Each half is at least as far as the gap to its extent along the split axis (and as its
+    // parent). Nearer half last, so it is searched first and shrinks best before the other.
+    float coordinate = axes[middle] ? y : x;
+    float belowGap = std::max(coordinate - lowerMax[middle], 0.0f);
+    float aboveGap = std::max(upperMin[middle] - coordinate, 0.0f);
+    Range lower{ range.first, middle, std::max(range.boundSquared, belowGap * belowGap) };
+    Range upper{ middle + 1, range.last, std::max(range.boundSquared, aboveGap * aboveGap) };
+    bool lowerFirst = lower.boundSquared < upper.boundSquared ||
+      (lower.boundSquared == upper.boundSquared && coordinate < (axes[middle] ? split.y : split.x));
+    if (lowerFirst)
+    {
+      stack[depth++] = upper;
+      stack[depth++] = lower;
+    }
+    else
+    {
+      stack[depth++] = lower;
+      stack[depth++] = upper;
+    }
+  }
+  return bestItem;
+}
+
+void KdTree::nearest(const float* xs, const float* ys, size_t count, uint32_t* outItems, JobPool* jobs) const
+{
+  auto run = [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; i++)
+      outItems[i] = nearest(xs[i], ys[i]);
+  };
+  if (jobs)
+    jobs->parallelFor(count, QUERY_BLOCK_SIZE, run);
+  else
+    run(0, count);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobPool;
+
+// 2-d tree over points for nearest-neighbour lookups. The tree is implicit in the point order:
+// a range of more than LEAF_SIZE points splits at its middle point, along the wider axis of
+// the range's box (the root's bounds, cut at each split), with the lower half before it
+// and the upper half after; smaller ranges are leaves scanned point by point. Items are
+// indices into the caller's coordinate arrays, and items with an infinite coordinate are
+// left out (dead).
+//
+// build sorts the points into a new tree (O(n log n): a median split per level with
+// nth_element), starting from the last build's order, which is nearly partitioned already
+// when the points moved a little. refit keeps the tree and only takes new coordinates for its
+// items (O(n)): each split keeps the lower half's largest and the upper half's smallest
+// coordinate along its axis instead of one split value, so lookups stay exact however far
+// points move, and only get slower as the halves come to overlap.
+class KdTree
+{
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+  static constexpr size_t LEAF_SIZE = 8;
+
+  // Items 0..count - 1, leaving out the infinite ones
+  void build(const float* xs, const float* ys, size_t count);
+
+  // Same items as the last build, read from arrays that still cover them; an item can die
+  // (go infinite) but not come back until the next build
+  void refit(const float* xs, const float* ys);
+
+  // Points in the tree, dead or alive
+  size_t size() const { return points.size(); }
+
+  // Item of the point nearest (x, y) closer than sqrt(maxDistanceSquared), NONE if there is none
+  uint32_t nearest(float x, float y, float maxDistanceSquared = INFINITY) const;
+
+  // nearest for count queries at once, split across jobs when given
+  void nearest(const float* xs, const float* ys, size_t count, uint32_t* outItems, JobPool* jobs = nullptr) const;
+
+private:
+  struct Point {
+    float x, y;
+    uint32_t item;
+  };
+
+  struct Box {
+    float minX, minY, maxX, maxY;
+  };
+
+  std::vector<Point> points;     // In tree order
+  std::vector<uint8_t> axes;     // Split axis (0 x, 1 y) of the range a point splits
+  std::vector<float> lowerMax;   // Largest coordinate along the split axis before the split point
+  std::vector<float> upperMin;   // Smallest after it
+  std::vector<uint8_t> seen;     // build scratch
+
+  void buildRange(size_t first, size_t last, float minX, float minY, float maxX, float maxY);
+  Box refitRange(size_t first, size_t last);
+};
@@ -8,9 +8,20 @@
 #include "projectile.h"
 #include "enemy.h"
 #include "camera.h"
+#include "ecs.h"
+#include "game_systems.h"
+#include "emitter.h"
+#include "rng.h"
+#include "fast_math.h"
+#include "profiler.h"
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "texture_loader.h"
+#include "texture_sampler.h"
 
 #include <cmath>
 #include <chrono>
+#include <cstdlib>
 #include <memory>
 
 #ifndef M_PI
@@ -23,13 +34,17 @@ using namespace std;
 double mouseX = 0.0, mouseY = 0.0;
 int windowWidth = 800, windowHeight = 600;
 
-// Game objects
+// Game objects (entities live in the world; the managers own their GL resources)
+std::unique_ptr<World> world;
+SystemScheduler systems;
 std::unique_ptr<Llama> llama;
 std::unique_ptr<ProjectileManager> projectileManager;
 std::unique_ptr<EnemyManager> enemyManager;
+std::unique_ptr<EmitterSystem> emitterSystem;
 std::unique_ptr<Camera> camera;
 std::shared_ptr<Shader> llamaShader;
 std::shared_ptr<Shader> projectileShader;
+std::shared_ptr<Shader> projectileSpriteShader;
 std::shared_ptr<Shader> enemyShader;
 
 // Mouse callback
@@ -47,24 +62,114 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
   glViewport(0, 0, width, height);
 }
 
+// Arm the llama with an emitter preset (no-op if it is already selected)
+void selectWeapon(const char* name)
+{
+  static std::string current;
+  if (current == name)
+    return;
+
+  Emitter emitter{ EmitterDesc(), 0.0f, 0.0f };
+  if (!emitter.desc.loadPreset(name))
+    return;
+
+  world->add(llama->getEntity(), emitter);
+  current = name;
+  std::cout << "Weapon: " << name << std::endl;
+}
+
 // Process input
 void processInput(GLFWwindow* window)
 {
   if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
     glfwSetWindowShouldClose(window, true);
+
+#if LLAMA_PROFILER
+  // F9 writes the last 300 frames as a Chrome trace (open in Perfetto)
+  static bool traceKeyWasDown = false;
+  bool traceKeyDown = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+  if (traceKeyDown && !traceKeyWasDown)
+    Profiler::exportRecentFrames("frame_trace.json", 300);
+  traceKeyWasDown = traceKeyDown;
+#endif
+
+  // F2 switches projectiles between per-quad and single-vertex sprite rendering
+  static bool modeKeyWasDown = false;
+  bool modeKeyDown = glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS;
+  if (modeKeyDown && !modeKeyWasDown)
+  {
+    bool useSprites = projectileManager->getRenderMode() == ProjectileRenderMode::Quads;
+    projectileManager->setRenderMode(useSprites ? ProjectileRenderMode::Sprites : ProjectileRenderMode::Quads);
+    std::cout << "Projectile rendering: " << (useSprites ? "sprites" : "quads") << std::endl;
+  }
+  modeKeyWasDown = modeKeyDown;
+
+  // F3 cycles the enemy collision broadphase
+  static bool collisionKeyWasDown = false;
+  bool collisionKeyDown = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+  if (collisionKeyDown && !collisionKeyWasDown)
+  {
+    CollisionBackend next = CollisionBackend(((int)enemyManager->getCollisionBackend() + 1) % 3);
+    enemyManager->setCollisionBackend(next);
+    std::cout << "Collision broadphase: " << getCollisionBackendName(next) << std::endl;
+  }
+  collisionKeyWasDown = collisionKeyDown;
+
+  // F4 toggles crowd steering (enemies keeping apart from each other)
+  static bool crowdKeyWasDown = false;
+  bool crowdKeyDown = glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS;
+  if (crowdKeyDown && !crowdKeyWasDown)
+  {
+    bool enabled = !enemyManager->getCrowdSteering();
+    enemyManager->setCrowdSteering(enabled);
+    std::cout << "Crowd steering: " << (enabled ? "on" : "off") << std::endl;
+  }
+  crowdKeyWasDown = crowdKeyDown;
+
+  // F5 toggles enemy overlap resolution
+  static bool overlapKeyWasDown = false;
+  bool overlapKeyDown = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+  if (overlapKeyDown && !overlapKeyWasDown)
+  {
+    bool enabled = !enemyManager->getOverlapResolution();
+    enemyManager->setOverlapResolution(enabled);
+    std::cout << "Enemy overlap resolution: " << (enabled ? "on" : "off") << std::endl;
+  }
+  overlapKeyWasDown = overlapKeyDown;
+
+  // Number keys pick the llama's weapon (emitter preset)
+  for (size_t i = 0; i < EmitterDesc::getPresetCount() && i < 9; i++)
+  {
+    if (glfwGetKey(window, GLFW_KEY_1 + (int)i) == GLFW_PRESS)
+      selectWeapon(EmitterDesc::getPresetName(i));
+  }
 }
 
 // Calculate angle from llama to mouse cursor
 float calculateLlamaAngle()
 {
+  PROFILE_ZONE("calculateLlamaAngle");
   float worldX, worldY;
   camera->screenToWorld((float)mouseX, (float)mouseY, windowWidth, windowHeight, worldX, worldY);
-  return -(atan2(worldX, worldY) - M_PI / 2.0f);
+  return FastMath::HALF_PI - FastMath::atan2(worldX, worldY);
 }
 
 // Initialize game objects
 bool initializeGame()
 {
+  // Filtering profiles are sampler objects shared by every texture
+  if (!TextureSampler::initialize())
+  {
+    std::cout << "Failed to create texture samplers" << std::endl;
+    return false;
+  }
+
+  // Start reading and decoding textures on worker threads so it overlaps shader compilation
+  AssetLoader assetLoader;
+  TextureRequest llamaTexture = assetLoader.requestTexture("llama.png");
+  TextureRequest projectileTexture = assetLoader.requestTexture("default_projectile.png");
+  TextureRequest enemyTexture = assetLoader.requestTexture("DinoSprites_tard.png");
+
   // Create shader sources
   const char* llamaVertexShader = R"(
 #version 330 core
@@ -96,20 +201,53 @@ void main()
 }
 )";
 
-  const char* projectileVertexShader = R"(
+  // Instanced quads (enemies, quad-mode projectiles): each instance is a SpriteInstance,
+  // a model matrix for the unit quad plus the frame's UVs, picked per corner by its index
+  const char* instancedSpriteVertexShader = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in mat4 aTransform;
+layout (location = 6) in vec4 aFrameUV0;   // top right, bottom right
+layout (location = 7) in vec4 aFrameUV1;   // bottom left, top left
 
 out vec2 TexCoord;
 
-uniform mat4 transform;
 uniform mat4 view;
 
 void main()
 {
-    gl_Position = view * transform * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
+    gl_Position = view * aTransform * vec4(aPos, 1.0);
+    vec2 frameUV[4] = vec2[4](aFrameUV0.xy, aFrameUV0.zw, aFrameUV1.xy, aFrameUV1.zw);
+    TexCoord = frameUV[gl_VertexID];
+}
+)";
+
+  // Single-vertex projectiles: each instance is (x, y, frame) and the quad
+  // corners come from gl_VertexID, drawn as a 4-vertex triangle strip
+  const char* projectileSpriteVertexShader = R"(
+#version 330 core
+layout (location = 0) in vec3 aSprite;
+
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform float halfSize;
+uniform int sheetColumns;
+uniform int sheetRows;
+
+const vec2 corners[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    vec2 corner = corners[gl_VertexID];
+    gl_Position = view * vec4(aSprite.xy + corner * halfSize, 0.0, 1.0);
+
+    // Grid sprite sheet, frame 0 at the top left
+    int frame = int(aSprite.z);
+    vec2 grid = vec2(sheetColumns, sheetRows);
+    vec2 cell = vec2(frame % sheetColumns, frame / sheetColumns);
+    vec2 uv = corner * 0.5 + 0.5;
+    TexCoord = vec2((cell.x + uv.x) / grid.x, 1.0 - (cell.y + 1.0 - uv.y) / grid.y);
 }
 )";
 
@@ -126,54 +264,75 @@ void main()
 }
 )";
 
-  // Create shaders
-  llamaShader = std::make_shared<Shader>(llamaVertexShader, llamaFragmentShader);
-  projectileShader = std::make_shared<Shader>(projectileVertexShader, projectileFragmentShader);
-  enemyShader = std::make_shared<Shader>(llamaVertexShader, llamaFragmentShader); // Reuse same shader
+  // Create shaders (a mounted asset pack can override the built-in sources by name)
+  {
+    StageTimer timer(assetLoader, "Shader compile");
+    std::string spriteVertex = AssetPack::resolveText("shaders/sprite.vert", llamaVertexShader);
+    std::string spriteFragment = AssetPack::resolveText("shaders/sprite.frag", llamaFragmentShader);
+    std::string instancedVertex = AssetPack::resolveText("shaders/sprite_instanced.vert", instancedSpriteVertexShader);
+    std::string projectileSpriteVertex = AssetPack::resolveText("shaders/projectile_sprite.vert", projectileSpriteVertexShader);
+    std::string projectileFragment = AssetPack::resolveText("shaders/projectile.frag", projectileFragmentShader);
+
+    llamaShader = std::make_shared<Shader>(spriteVertex.c_str(), spriteFragment.c_str());
+    projectileShader = std::make_shared<Shader>(instancedVertex.c_str(), projectileFragment.c_str());
+    projectileSpriteShader = std::make_shared<Shader>(projectileSpriteVertex.c_str(), projectileFragment.c_str());
+    enemyShader = std::make_shared<Shader>(instancedVertex.c_str(), spriteFragment.c_str());
+  }
 
   // Create game objects
-  llama = std::make_unique<Llama>();
-  projectileManager = std::make_unique<ProjectileManager>();
-  enemyManager = std::make_unique<EnemyManager>();
+  world = std::make_unique<World>();
+  llama = std::make_unique<Llama>(*world);
+  projectileManager = std::make_unique<ProjectileManager>(*world);
+  enemyManager = std::make_unique<EnemyManager>(*world);
+  emitterSystem = std::make_unique<EmitterSystem>(*world, *projectileManager);
   camera = std::make_unique<Camera>();
 
+  // Per-frame systems, in order: spawn, homing, shared motion and animation, firing, enemy
+  // overlaps, hits, then cleanup
+  systems.add("Enemies", [](World&, float dt) {
+    enemyManager->setTarget(llama->getX(), llama->getY());
+    enemyManager->update(dt);
+  });
+  systems.add("Homing", [](World&, float dt) { projectileManager->steerHoming(dt, enemyManager.get()); });
+  systems.add("Integrate", GameSystems::integrate);
+  systems.add("Emitters", [](World&, float dt) { emitterSystem->update(dt); });
+  systems.add("Enemy overlap", [](World&, float) { enemyManager->resolveOverlaps(); });
+  systems.add("Projectile collision", [](World&, float dt) { projectileManager->update(dt, enemyManager.get()); });
+  systems.add("Expiry", GameSystems::expiry);
+
   // Initialize llama
-  if (!llama->initialize("assets/llama.png"))
+  if (!llama->initializeWithTexture(assetLoader.finishTexture(llamaTexture)))
   {
-    // Try alternative path
-    if (!llama->initialize("llama.png"))
-    {
-      std::cout << "Failed to initialize llama!" << std::endl;
-      return false;
-    }
+    std::cout << "Failed to initialize llama!" << std::endl;
+    return false;
   }
 
   // Initialize projectile manager
-  if (!projectileManager->initialize("assets/default_projectile.png"))
+  if (!projectileManager->initializeWithTexture(assetLoader.finishTexture(projectileTexture)))
   {
-    // Try alternative path
-    if (!projectileManager->initialize("default_projectile.png"))
-    {
-      std::cout << "Failed to initialize projectile manager!" << std::endl;
-      return false;
-    }
+    std::cout << "Failed to initialize projectile manager!" << std::endl;
+    return false;
   }
 
   // Initialize enemy manager
-  if (!enemyManager->initialize("assets/DinoSprites_tard.png"))
+  if (!enemyManager->initializeWithTexture(assetLoader.finishTexture(enemyTexture)))
   {
-    // Try alternative path
-    if (!enemyManager->initialize("DinoSprites_tard.png"))
-    {
-      std::cout << "Failed to initialize enemy manager!" << std::endl;
-      return false;
-    }
+    std::cout << "Failed to initialize enemy manager!" << std::endl;
+    return false;
   }
 
+  assetLoader.printStartupReport();
+
+  // Submit one vertex per projectile instead of a full quad
+  projectileManager->setRenderMode(ProjectileRenderMode::Sprites);
+
   // Configure enemy spawning (expand spawn area for larger view)
   enemyManager->setMaxEnemies(5000);
   enemyManager->setSpawnRate(5.0f); // 0.5 enemies per second
 
+  // Shoot with the rifle until another weapon is picked
+  selectWeapon("rifle");
+
   // Set camera zoom for better field of view
   camera->setZoom(2.5f); // 2.5x zoom out to see more area
 
@@ -209,10 +368,19 @@ int main()
     return -1;
   }
 
-  // Enable blending for transparency
+  // Enable blending for transparency (renderers switch to GL_ONE for premultiplied textures)
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+  // Use the single-file asset pack when one is deployed, loose files otherwise
+  if (!AssetPack::mount("assets.lpak"))
+    AssetPack::mount("assets/assets.lpak");
+
+  // Every random stream derives from one seed; set LLAMA_SEED to replay a run
+  if (const char* seed = std::getenv("LLAMA_SEED"))
+    Random::setGlobalSeed(std::strtoull(seed, nullptr, 10));
+  std::cout << "Random seed: " << Random::getGlobalSeed() << std::endl;
+
   // Initialize game objects
   if (!initializeGame())
   {
@@ -222,71 +390,105 @@ int main()
   }
 
   glViewport(0, 0, windowWidth, windowHeight);
+  Profiler::setThreadName("Main");
 
   // Timing variables
   auto currentTime = std::chrono::steady_clock::now();
   auto lastTime = currentTime;
 
+  // Camera version last sent to the shaders (none yet)
+  unsigned int uploadedViewVersion = ~0u;
+
   // Render loop
   while (!glfwWindowShouldClose(window))
   {
+    PROFILE_FRAME();
+    PROFILE_ZONE("Frame");
+
     // Calculate delta time
     currentTime = std::chrono::steady_clock::now();
     float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
     lastTime = currentTime;
 
-    processInput(window);
+    {
+      PROFILE_ZONE("Input");
+      processInput(window);
+    }
 
-    // Calculate llama rotation and update
-    float llamaAngle = calculateLlamaAngle();
-    llama->setRotation(llamaAngle);
-    llama->update(deltaTime); // Add animation update
+    // Aim the llama (and its emitter) at the mouse
+    llama->setRotation(calculateLlamaAngle());
 
-    // Shoot projectiles with timing error and spray
-    if (projectileManager->canShoot(200.0f, 2.0f)) // 200ms base interval, 2% timing error
+    // Spawn, move, animate, collide and expire every entity
     {
-      projectileManager->addProjectile(llama->getX(), llama->getY(), llamaAngle); // Uses 1% spray by default
-      projectileManager->updateLastShotTime();
+      PROFILE_ZONE("Update");
+      systems.run(*world, deltaTime);
     }
 
-    // Update projectiles with enemy collision detection
-    projectileManager->update(deltaTime, enemyManager.get());
+    {
+      PROFILE_ZONE("Render prep");
 
-    // Update enemies
-    enemyManager->update(deltaTime);
+      // Clear screen
+      glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
 
-    // Clear screen
-    glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+      // Uniforms persist per program, so the view only goes out when the camera changed
+      if (camera->getVersion() != uploadedViewVersion)
+      {
+        const float* viewMatrix = camera->getViewProjection().data();
 
-    // Create and set view matrix for all shaders
-    float viewMatrix[16];
-    camera->createViewMatrix(viewMatrix);
+        llamaShader->use();
+        llamaShader->setViewMatrix(viewMatrix);
 
-    // Set view matrix for all shaders
-    llamaShader->use();
-    llamaShader->setViewMatrix(viewMatrix);
+        projectileShader->use();
+        projectileShader->setViewMatrix(viewMatrix);
 
-    projectileShader->use();
-    projectileShader->setViewMatrix(viewMatrix);
+        projectileSpriteShader->use();
+        projectileSpriteShader->setViewMatrix(viewMatrix);
 
-    enemyShader->use();
-    enemyShader->setViewMatrix(viewMatrix);
+        enemyShader->use();
+        enemyShader->setViewMatrix(viewMatrix);
 
-    // Render llama
-    llama->render(llamaShader);
+        uploadedViewVersion = camera->getVersion();
+      }
+    }
 
-    // Render projectiles
-    projectileManager->render(projectileShader);
+    {
+      PROFILE_ZONE("Render");
 
-    // Render enemies
-    enemyManager->render(enemyShader);
+      // Render llama
+      llama->render(llamaShader);
 
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+      // Render projectiles
+      bool spriteMode = projectileManager->getRenderMode() == ProjectileRenderMode::Sprites;
+      projectileManager->render(spriteMode ? projectileSpriteShader : projectileShader);
+
+      // Render enemies
+      enemyManager->render(enemyShader);
+    }
+
+    {
+      PROFILE_ZONE("Swap");
+      glfwSwapBuffers(window);
+    }
+    {
+      PROFILE_ZONE("Poll events");
+      glfwPollEvents();
+    }
   }
 
-  // Cleanup is handled by destructors
+  // Release GL resources while the context still exists
+  emitterSystem.reset();
+  llama.reset();
+  projectileManager.reset();
+  enemyManager.reset();
+  world.reset();
+  llamaShader.reset();
+  projectileShader.reset();
+  projectileSpriteShader.reset();
+  enemyShader.reset();
+  TextureLoader::evictUnusedTextures();
+  TextureSampler::shutdown();
+
   glfwTerminate();
   return 0;
 }
\ No newline at end of file
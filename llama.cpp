@@ -36,8 +36,12 @@ void main()
 }
 )";
 
-Llama::Llama() : rotation(0.0f), animationTime(0.0f), animationSpeed(8.0f), currentFrame(0), VAO(0), VBO(0), EBO(0), texture(0)
+Llama::Llama(World& world) : world(world), VAO(0), VBO(0), EBO(0), texture(0),
+  samplerProfile(SamplerProfile::PixelArt)
 {
+  // Always at the center, 8 fps walk cycle
+  entity = world.create(Position{ 0.0f, 0.0f }, Rotation{ 0.0f }, Age{ 0.0f },
+    SpriteAnimation{ 8.0f, DinoSpriteSheet::frameCount, 0 }, LlamaTag{});
 }
 
 Llama::~Llama()
@@ -45,24 +49,41 @@ Llama::~Llama()
   if (VAO) glDeleteVertexArrays(1, &VAO);
   if (VBO) glDeleteBuffers(1, &VBO);
   if (EBO) glDeleteBuffers(1, &EBO);
-  if (texture) glDeleteTextures(1, &texture);
+  if (texture) TextureLoader::releaseTexture(texture);
+  world.destroy(entity);
 }
 
 bool Llama::initialize(const char* texturePath)
 {
-  setupMesh();
-
   // Load texture
-  texture = loadTexture(texturePath);
-  if (texture == 0)
+  unsigned int loaded = loadTexture(texturePath);
+  if (loaded == 0)
   {
     std::cout << "Failed to load llama texture: " << texturePath << std::endl;
     return false;
   }
 
+  return initializeWithTexture(loaded);
+}
+
+bool Llama::initializeWithTexture(unsigned int textureID)
+{
+  if (textureID == 0)
+    return false;
+
+  setupMesh();
+
+  texture = textureID;
+  TextureSampler::prepareTexture(texture, samplerProfile);
   return true;
 }
 
+void Llama::setSamplerProfile(SamplerProfile profile)
+{
+  samplerProfile = profile;
+  TextureSampler::prepareTexture(texture, samplerProfile);
+}
+
 void Llama::setupMesh()
 {
   // Vertex data for llama quad
@@ -99,85 +120,41 @@ void Llama::setupMesh()
 
 unsigned int Llama::loadTexture(const char* path)
 {
-  return TextureLoader::loadTexture(path);
-}
-
-void Llama::update(float deltaTime)
-{
-  animationTime += deltaTime;
-
-  // Update animation frame (change frame based on animation speed)
-  currentFrame = (int)(animationTime * animationSpeed) % 24; // 24 frames total
-}
-
-void Llama::getFrameCoords(int frame, float coords[8])
-{
-  // Sprite sheet: 120x120, 5x5 grid (24 frames total), each frame 24x24
-  // Frame layout based on JSON:
-  // 0  | 1  | 2  | 3  | 4     (y=0)
-  // 5  | 6  | 7  | 8  | 9     (y=24) 
-  // 10 | 11 | 12 | 13 | 14    (y=48)
-  // 15 | 16 | 17 | 18 | 19    (y=72)
-  // 20 | 21 | 22 | 23 | --    (y=96)
-
-  float frameWidth = 24.0f / 120.0f;   // 24/120 = 0.2
-  float frameHeight = 24.0f / 120.0f;  // 24/120 = 0.2
-
-  int col = frame % 5;       // 0, 1, 2, 3, or 4
-  int row = frame / 5;       // 0, 1, 2, 3, or 4
-
-  float left = col * frameWidth;
-  float right = left + frameWidth;
-  float top = 1.0f - (row * frameHeight);      // Flip Y for OpenGL
-  float bottom = top - frameHeight;
-
-  // Texture coordinates for quad (top-right, bottom-right, bottom-left, top-left)
-  coords[0] = right; coords[1] = top;      // top right
-  coords[2] = right; coords[3] = bottom;   // bottom right  
-  coords[4] = left;  coords[5] = bottom;   // bottom left
-  coords[6] = left;  coords[7] = top;      // top left
+  // Shared through the registry, so another system using the same sheet reuses this upload
+  return TextureLoader::acquireTexture(path);
 }
 
 void Llama::render(std::shared_ptr<Shader> shader)
 {
   shader->use();
 
+  const Position& position = *world.get<Position>(entity);
+  float rotation = world.get<Rotation>(entity)->angle;
+
   // Get texture coordinates for current frame
-  float frameCoords[8];
-  getFrameCoords(currentFrame, frameCoords);
+  const FrameUV& frameUV = DinoSpriteSheet::frame(world.get<SpriteAnimation>(entity)->frame);
 
   // Update vertex buffer with new texture coordinates
   float llamaVertices[] = {
     // positions        // texture coords (updated per frame)
-     0.3f,  0.3f, 0.0f,  frameCoords[0], frameCoords[1],  // top right
-     0.3f, -0.3f, 0.0f,  frameCoords[2], frameCoords[3],  // bottom right
-    -0.3f, -0.3f, 0.0f,  frameCoords[4], frameCoords[5],  // bottom left
-    -0.3f,  0.3f, 0.0f,  frameCoords[6], frameCoords[7]   // top left
+     0.3f,  0.3f, 0.0f,  frameUV.coords[0], frameUV.coords[1],  // top right
+     0.3f, -0.3f, 0.0f,  frameUV.coords[2], frameUV.coords[3],  // bottom right
+    -0.3f, -0.3f, 0.0f,  frameUV.coords[4], frameUV.coords[5],  // bottom left
+    -0.3f,  0.3f, 0.0f,  frameUV.coords[6], frameUV.coords[7]   // top left
   };
 
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
   glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(llamaVertices), llamaVertices);
 
-  // Create transformation matrix
-  float transform[16];
-  float cosA = cos(rotation);
-  float sinA = sin(rotation);
-
-  // Initialize to identity matrix
-  for (int i = 0; i < 16; i++)
-    transform[i] = 0.0f;
-
-  // Set rotation matrix values (no translation since llama stays at center)
-  transform[0] = cosA;   transform[1] = sinA;   transform[2] = 0.0f;  transform[3] = 0.0f;
-  transform[4] = -sinA;  transform[5] = cosA;   transform[6] = 0.0f;  transform[7] = 0.0f;
-  transform[8] = 0.0f;   transform[9] = 0.0f;   transform[10] = 1.0f; transform[11] = 0.0f;
-  transform[12] = 0.0f;  transform[13] = 0.0f;  transform[14] = 0.0f; transform[15] = 1.0f;
-
-  shader->setMatrix4fv("transform", transform);
+  // Rotation about the llama's position (the center, in practice)
+  Mat4 transform = Mat4::translation(position.x, position.y) * Mat4::rotationZ(rotation);
+  shader->setMatrix4fv("transform", transform.data());
 
   // Bind texture
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, texture);
+  TextureSampler::bind(samplerProfile, 0);
+  TextureLoader::applyBlendFunc(texture);
   shader->setInt("ourTexture", 0);
 
   // Render
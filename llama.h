@@ -1,47 +1,59 @@
 #pragma once
 
+#include "texture_sampler.h"
+#include "sprite_sheet.h"
+#include "transform_math.h"
+#include "ecs.h"
+#include "components.h"
 #include <memory>
 
 class Shader;
 
+// The llama is a World entity with Position, Rotation, Age, SpriteAnimation and LlamaTag;
+// its animation runs with the shared systems
 class Llama
 {
 public:
-  Llama();
+  explicit Llama(World& world);
   ~Llama();
 
   // Initialize OpenGL resources
   bool initialize(const char* texturePath);
 
+  // Initialize OpenGL resources with an already acquired texture (takes over that reference)
+  bool initializeWithTexture(unsigned int textureID);
+
   // Set llama rotation angle
-  void setRotation(float angle) { rotation = angle; }
+  void setRotation(float angle) { world.get<Rotation>(entity)->angle = angle; }
 
   // Get current rotation
-  float getRotation() const { return rotation; }
-
-  // Update animation
-  void update(float deltaTime);
+  float getRotation() const { return world.get<Rotation>(entity)->angle; }
 
   // Render the llama
   void render(std::shared_ptr<Shader> shader);
 
   // Get position (center of llama)
-  float getX() const { return 0.0f; }  // Llama is always at center
-  float getY() const { return 0.0f; }
+  float getX() const { return world.get<Position>(entity)->x; }  // Llama is always at center
+  float getY() const { return world.get<Position>(entity)->y; }
+
+  Entity getEntity() const { return entity; }
 
   // Animation control
-  void setAnimationSpeed(float speed) { animationSpeed = speed; }
-  void setCurrentFrame(int frame) { currentFrame = frame % 24; } // 24 frames total
+  void setAnimationSpeed(float speed) { world.get<SpriteAnimation>(entity)->framesPerSecond = speed; }
+  void setCurrentFrame(int frame) { world.get<SpriteAnimation>(entity)->frame = frame % DinoSpriteSheet::frameCount; }
+
+  // Filtering used when sampling the texture
+  void setSamplerProfile(SamplerProfile profile);
+  SamplerProfile getSamplerProfile() const { return samplerProfile; }
 
 private:
-  float rotation;
-  float animationTime;
-  float animationSpeed;
-  int currentFrame;
+  World& world;
+  Entity entity;
 
   // OpenGL resources
   unsigned int VAO, VBO, EBO;
   unsigned int texture;
+  SamplerProfile samplerProfile;
 
   // Shader sources
   static const char* vertexShaderSource;
@@ -50,5 +62,4 @@ private:
   // Helper functions
   void setupMesh();
   unsigned int loadTexture(const char* path);
-  void getFrameCoords(int frame, float coords[8]);
 };
\ No newline at end of file
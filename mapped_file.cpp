@@ -0,0 +1,115 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : mappedData(nullptr), mappedSize(0), fileHandle(nullptr), mappingHandle(nullptr)
+{
+}
+#else
+MappedFile::MappedFile() : mappedData(nullptr), mappedSize(0)
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path)
+{
+  close();
+
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view)
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  fileHandle = file;
+  mappingHandle = mapping;
+  mappedData = (const unsigned char*)view;
+  mappedSize = (size_t)fileSize.QuadPart;
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (mappedData) UnmapViewOfFile(mappedData);
+  if (mappingHandle) CloseHandle(mappingHandle);
+  if (fileHandle) CloseHandle(fileHandle);
+
+  mappedData = nullptr;
+  mappedSize = 0;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char* path)
+{
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // The mapping keeps the file referenced
+  if (view == MAP_FAILED)
+    return false;
+
+  mappedData = (const unsigned char*)view;
+  mappedSize = (size_t)info.st_size;
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (mappedData) munmap((void*)mappedData, mappedSize);
+
+  mappedData = nullptr;
+  mappedSize = 0;
+}
+
+#endif
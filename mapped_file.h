@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file.
+// Pages are shared through the OS page cache, so several processes mapping
+// the same asset only pay for one copy.
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Map a file; returns false if it does not exist or cannot be mapped
+  bool open(const char* path);
+
+  // Unmap (also done by the destructor)
+  void close();
+
+  bool isOpen() const { return mappedData != nullptr; }
+  const unsigned char* data() const { return mappedData; }
+  size_t size() const { return mappedSize; }
+
+private:
+  const unsigned char* mappedData;
+  size_t mappedSize;
+
+#ifdef _WIN32
+  void* fileHandle;
+  void* mappingHandle;
+#endif
+};
@@ -0,0 +1,177 @@
+#include "profiler.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+  // Ring buffer owned by a single recording thread
+  struct ThreadBuffer {
+    std::vector<ProfileEvent> events;
+    std::atomic<uint64_t> head{ 0 };   // Total number of events ever written
+    uint32_t threadId;
+    std::string name;
+
+    explicit ThreadBuffer(uint32_t id) : events(Profiler::RING_CAPACITY), threadId(id) {}
+  };
+
+  std::mutex registryMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+  std::atomic<uint64_t> frameIndex{ 0 };
+  const auto profilerStart = std::chrono::steady_clock::now();
+
+  thread_local ThreadBuffer* localBuffer = nullptr;
+  thread_local uint32_t localDepth = 0;
+
+  ThreadBuffer* getLocalBuffer()
+  {
+    if (!localBuffer)
+    {
+      // Buffers live until exit so exported data stays valid after a thread ends
+      std::lock_guard<std::mutex> lock(registryMutex);
+      threadBuffers.push_back(std::make_unique<ThreadBuffer>((uint32_t)threadBuffers.size() + 1));
+      localBuffer = threadBuffers.back().get();
+    }
+    return localBuffer;
+  }
+
+  void writeEscaped(std::ostream& out, const char* text)
+  {
+    for (const char* c = text; *c; ++c)
+    {
+      if (*c == '"' || *c == '\\')
+        out << '\\';
+      out << *c;
+    }
+  }
+}
+
+void Profiler::beginFrame()
+{
+  frameIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::getFrameIndex()
+{
+  return frameIndex.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - profilerStart).count();
+}
+
+void Profiler::setThreadName(const char* name)
+{
+  ThreadBuffer* buffer = getLocalBuffer();
+  std::lock_guard<std::mutex> lock(registryMutex);
+  buffer->name = name;
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs, uint64_t frame, uint32_t depth)
+{
+  ThreadBuffer* buffer = getLocalBuffer();
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+
+  ProfileEvent& event = buffer->events[head % RING_CAPACITY];
+  event.name = name;
+  event.startNs = startNs;
+  event.endNs = endNs;
+  event.frame = frame;
+  event.depth = depth;
+
+  // Publish after the slot is filled so the exporter never sees a half-written event
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Profiler::exportChromeTrace(const char* path, uint64_t firstFrame, uint64_t lastFrame)
+{
+  std::ofstream out(path);
+  if (!out)
+  {
+    std::cout << "Failed to open trace file: " << path << std::endl;
+    return false;
+  }
+
+  struct ExportEvent {
+    ProfileEvent event;
+    uint32_t threadId;
+  };
+  std::vector<ExportEvent> selected;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer : threadBuffers)
+    {
+      // Thread name metadata so Perfetto labels each track
+      std::string threadName = buffer->name.empty() ? "thread " + std::to_string(buffer->threadId) : buffer->name;
+      out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+        << ",\"args\":{\"name\":\"";
+      writeEscaped(out, threadName.c_str());
+      out << "\"}}";
+      first = false;
+
+      uint64_t head = buffer->head.load(std::memory_order_acquire);
+      uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+      for (uint64_t i = begin; i < head; i++)
+      {
+        const ProfileEvent& event = buffer->events[i % RING_CAPACITY];
+        if (event.frame >= firstFrame && event.frame <= lastFrame)
+          selected.push_back({ event, buffer->threadId });
+      }
+    }
+  }
+
+  // Parents before children, so viewers nest zones that share a start time correctly
+  std::sort(selected.begin(), selected.end(), [](const ExportEvent& a, const ExportEvent& b) {
+    if (a.event.startNs != b.event.startNs) return a.event.startNs < b.event.startNs;
+    return a.event.depth < b.event.depth;
+  });
+
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  for (const auto& item : selected)
+  {
+    out << ",\n{\"name\":\"";
+    writeEscaped(out, item.event.name);
+    out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << item.threadId
+      << ",\"ts\":" << item.event.startNs / 1000.0
+      << ",\"dur\":" << (item.event.endNs - item.event.startNs) / 1000.0
+      << ",\"args\":{\"frame\":" << item.event.frame << "}}";
+  }
+
+  out << "\n]}\n";
+  std::cout << "Wrote " << selected.size() << " zones for frames " << firstFrame << "-" << lastFrame
+    << " to " << path << std::endl;
+  return true;
+}
+
+bool Profiler::exportRecentFrames(const char* path, uint64_t frameCount)
+{
+  // The current frame is still being recorded, so end at the previous one
+  uint64_t current = getFrameIndex();
+  uint64_t last = current > 0 ? current - 1 : 0;
+  uint64_t firstFrame = last >= frameCount ? last - frameCount + 1 : 0;
+  return exportChromeTrace(path, firstFrame, last);
+}
+
+ProfileZone::ProfileZone(const char* zoneName)
+  : name(zoneName), startNs(Profiler::now()), frame(Profiler::getFrameIndex()), depth(localDepth++)
+{
+}
+
+ProfileZone::~ProfileZone()
+{
+  localDepth--;
+  Profiler::record(name, startNs, Profiler::now(), frame, depth);
+}
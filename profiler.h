@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+// Set LLAMA_PROFILER to 0 (CMake option LLAMA_ENABLE_PROFILER=OFF) to strip all zones
+#ifndef LLAMA_PROFILER
+#define LLAMA_PROFILER 1
+#endif
+
+// A finished zone as stored in a thread's ring buffer
+struct ProfileEvent {
+  const char* name;    // Zone name (must be a string literal / static string)
+  uint64_t startNs;    // Start time since profiler start
+  uint64_t endNs;      // End time since profiler start
+  uint64_t frame;      // Frame index the zone started in
+  uint32_t depth;      // Nesting depth on its thread (0 = outermost)
+};
+
+// Hierarchical CPU frame profiler.
+// Zones are recorded into a per-thread ring buffer, so recording never locks.
+// Export writes Chrome trace-event JSON that can be opened in Perfetto or chrome://tracing.
+class Profiler
+{
+public:
+  // Number of events kept per thread before the oldest are overwritten
+  static const uint32_t RING_CAPACITY = 1u << 16;
+
+  // Mark the start of a new frame (call once per frame from the main thread)
+  static void beginFrame();
+
+  // Index of the current frame
+  static uint64_t getFrameIndex();
+
+  // Nanoseconds since the profiler was first used
+  static uint64_t now();
+
+  // Name the calling thread in exported traces
+  static void setThreadName(const char* name);
+
+  // Store a finished zone in the calling thread's ring buffer
+  static void record(const char* name, uint64_t startNs, uint64_t endNs, uint64_t frame, uint32_t depth);
+
+  // Write all zones that started in frames [firstFrame, lastFrame] as Chrome trace JSON.
+  // Call from the main thread between frames.
+  static bool exportChromeTrace(const char* path, uint64_t firstFrame, uint64_t lastFrame);
+
+  // Convenience: export the most recent frameCount completed frames
+  static bool exportRecentFrames(const char* path, uint64_t frameCount);
+};
+
+// RAII zone: measures from construction to destruction
+class ProfileZone
+{
+public:
+  explicit ProfileZone(const char* zoneName);
+  ~ProfileZone();
+
+  ProfileZone(const ProfileZone&) = delete;
+  ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+  const char* name;
+  uint64_t startNs;
+  uint64_t frame;
+  uint32_t depth;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if LLAMA_PROFILER
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::beginFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
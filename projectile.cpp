@@ -2,6 +2,8 @@
 #include "shader.h"
 #include "texture_loader.h"
 #include "enemy.h"
+#include "profiler.h"
+#include "fast_math.h"
 #include <glad/glad.h>
 #include <iostream>
 #include <cmath>
@@ -43,13 +45,10 @@ void main()
 }
 )";
 
-Projectile::Projectile(float startX, float startY, float vx, float vy)
-  : x(startX), y(startY), velX(vx), velY(vy), life(0.0f), frame(0)
-{
-}
-
-ProjectileManager::ProjectileManager() : VAO(0), VBO(0), EBO(0), texture(0),
-gen(rd()), dis(-1.0f, 1.0f), lastShotTime(std::chrono::steady_clock::now())
+ProjectileManager::ProjectileManager(World& world) : world(world), rng(Random::makeRng("projectiles")),
+lastShotTime(std::chrono::steady_clock::now()), VAO(0), VBO(0), EBO(0), instanceVBO(0), instanceCapacity(0), texture(0),
+samplerProfile(SamplerProfile::PixelArt),
+renderMode(ProjectileRenderMode::Quads), spriteVAO(0), spriteVBO(0), spriteBufferCapacity(0)
 {
 }
 
@@ -58,33 +57,54 @@ ProjectileManager::~ProjectileManager()
   if (VAO) glDeleteVertexArrays(1, &VAO);
   if (VBO) glDeleteBuffers(1, &VBO);
   if (EBO) glDeleteBuffers(1, &EBO);
-  if (texture) glDeleteTextures(1, &texture);
+  if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+  if (spriteVAO) glDeleteVertexArrays(1, &spriteVAO);
+  if (spriteVBO) glDeleteBuffers(1, &spriteVBO);
+  if (texture) TextureLoader::releaseTexture(texture);
+  clear();
 }
 
 bool ProjectileManager::initialize(const char* texturePath)
 {
-  setupMesh();
-
   // Load texture
-  texture = loadTexture(texturePath);
-  if (texture == 0)
+  unsigned int loaded = loadTexture(texturePath);
+  if (loaded == 0)
   {
     std::cout << "Failed to load projectile texture: " << texturePath << std::endl;
     return false;
   }
 
+  return initializeWithTexture(loaded);
+}
+
+bool ProjectileManager::initializeWithTexture(unsigned int textureID)
+{
+  if (textureID == 0)
+    return false;
+
+  setupMesh();
+  setupSpriteMesh();
+
+  texture = textureID;
+  TextureSampler::prepareTexture(texture, samplerProfile);
   return true;
 }
 
+void ProjectileManager::setSamplerProfile(SamplerProfile profile)
+{
+  samplerProfile = profile;
+  TextureSampler::prepareTexture(texture, samplerProfile);
+}
+
 void ProjectileManager::setupMesh()
 {
-  // Vertex data for projectile ball
+  // Unit quad, scaled per projectile by its instance transform; the vertex shader picks
+  // each corner's UV from the instance by its index, so the order matches FrameUV
   float ballVertices[] = {
-    // positions        // texture coords
-     0.08f,  0.08f, 0.0f,  0.5f, 1.0f,     // top right 
-     0.08f, -0.08f, 0.0f,  0.5f, 0.5f,     // bottom right
-    -0.08f, -0.08f, 0.0f,  0.0f, 0.5f,     // bottom left
-    -0.08f,  0.08f, 0.0f,  0.0f, 1.0f      // top left 
+     1.0f,  1.0f, 0.0f,   // top right
+     1.0f, -1.0f, 0.0f,   // bottom right
+    -1.0f, -1.0f, 0.0f,   // bottom left
+    -1.0f,  1.0f, 0.0f    // top left
   };
 
   unsigned int indices[] = {
@@ -95,6 +115,7 @@ void ProjectileManager::setupMesh()
   glGenVertexArrays(1, &VAO);
   glGenBuffers(1, &VBO);
   glGenBuffers(1, &EBO);
+  glGenBuffers(1, &instanceVBO);
 
   glBindVertexArray(VAO);
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -103,39 +124,205 @@ void ProjectileManager::setupMesh()
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
   // Position attribute
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+  glEnableVertexAttribArray(0);
+
+  // Per-instance attributes: the transform's four columns, then the frame UVs in two halves
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  for (unsigned int column = 0; column < 4; column++)
+  {
+    glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+      (void*)(offsetof(SpriteInstance, transform) + column * 4 * sizeof(float)));
+    glEnableVertexAttribArray(2 + column);
+    glVertexAttribDivisor(2 + column, 1);
+  }
+  for (unsigned int half = 0; half < 2; half++)
+  {
+    glVertexAttribPointer(6 + half, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+      (void*)(offsetof(SpriteInstance, uv) + half * 4 * sizeof(float)));
+    glEnableVertexAttribArray(6 + half);
+    glVertexAttribDivisor(6 + half, 1);
+  }
+
+  glBindVertexArray(0);
+}
+
+void ProjectileManager::setupSpriteMesh()
+{
+  // No per-corner data: the vertex shader builds the quad from gl_VertexID,
+  // and each projectile contributes a single instanced (x, y, frame) vertex
+  glGenVertexArrays(1, &spriteVAO);
+  glGenBuffers(1, &spriteVBO);
+
+  glBindVertexArray(spriteVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, spriteVBO);
+
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
   glEnableVertexAttribArray(0);
-  // Texture coordinate attribute
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  glVertexAttribDivisor(0, 1); // Advance once per instance (projectile)
+
+  glBindVertexArray(0);
 }
 
 unsigned int ProjectileManager::loadTexture(const char* path)
 {
-  return TextureLoader::loadTexture(path);
+  // Shared through the registry, so another system using the same sheet reuses this upload
+  return TextureLoader::acquireTexture(path);
 }
 
-void ProjectileManager::addProjectile(float startX, float startY, float angle, float speed)
+ProjectileHandle ProjectileManager::addProjectile(float startX, float startY, float angle, float speed)
 {
   // Use default 1% spray
-  addProjectileWithSpray(startX, startY, angle, speed, 1.0f);
+  return addProjectileWithSpray(startX, startY, angle, speed, 1.0f);
 }
 
-void ProjectileManager::addProjectileWithSpray(float startX, float startY, float angle, float speed, float sprayPercent)
+ProjectileHandle ProjectileManager::addProjectileWithSpray(float startX, float startY, float angle, float speed, float sprayPercent)
 {
   // Calculate spray angle in radians
   // 1% spray = 1% of a full circle = 0.01 * 2π radians = ~0.0628 radians (~3.6 degrees)
   float maxSprayRadians = (sprayPercent / 100.0f) * 2.0f * M_PI;
 
   // Generate random spray offset
-  float sprayOffset = dis(gen) * maxSprayRadians;
+  float sprayOffset = rng.uniform(-1.0f, 1.0f) * maxSprayRadians;
   float finalAngle = angle + sprayOffset;
 
   // Calculate velocity with spray applied
-  float velX = cos(finalAngle) * speed;
-  float velY = sin(finalAngle) * speed;
+  float sinAngle, cosAngle;
+  FastMath::sinCos(finalAngle, sinAngle, cosAngle);
+  float velX = cosAngle * speed;
+  float velY = sinAngle * speed;
+
+  // 10 fps spin, removed after 5 seconds or once off-screen
+  return world.create(Position{ startX, startY }, Velocity{ velX, velY }, Age{ 0.0f },
+    SpriteAnimation{ 10.0f, ProjectileSpriteSheet::frameCount, 0 }, Expiry{ 5.0f, 5.0f }, ProjectileBody{ 0.08f });
+}
+
+void ProjectileManager::spawnBatch(size_t count, const float* xs, const float* ys, const float* angles,
+  const float* speeds, const float* ages, const float* turnRates, const float* retargetIntervals,
+  const float* retargetDelays, const float* blastRadii, const int* blastDamages)
+{
+  PROFILE_ZONE("Projectile batch");
+  batchSines.resize(count);
+  batchCosines.resize(count);
+  FastMath::sinCos(angles, batchSines.data(), batchCosines.data(), count);
+
+  // Homing and Explosive each make another archetype; plain shots have the same components
+  // as addProjectileWithSpray, so they land in its archetype
+  auto write = [&](ChunkView chunk, size_t firstRow, size_t rowCount, size_t batchIndex) {
+    writeBatchRows(chunk, firstRow, rowCount, batchIndex, xs, ys, speeds, ages);
+    if (turnRates)
+    {
+      Homing* homing = chunk.get<Homing>() + firstRow;
+      for (size_t r = 0; r < rowCount; r++)
+      {
+        size_t i = batchIndex + r;
+        homing[r] = Homing{ turnRates[i], retargetIntervals[i], retargetDelays ? retargetDelays[i] : 0.0f, Entity() };
+      }
+    }
+    if (blastRadii)
+    {
+      Explosive* explosive = chunk.get<Explosive>() + firstRow;
+      for (size_t r = 0; r < rowCount; r++)
+        explosive[r] = Explosive{ blastRadii[batchIndex + r], blastDamages[batchIndex + r] };
+    }
+  };
+
+  if (turnRates && blastRadii)
+    world.createBatch<Position, Velocity, Age, SpriteAnimation, Expiry, ProjectileBody, Homing, Explosive>(count, write);
+  else if (turnRates)
+    world.createBatch<Position, Velocity, Age, SpriteAnimation, Expiry, ProjectileBody, Homing>(count, write);
+  else if (blastRadii)
+    world.createBatch<Position, Velocity, Age, SpriteAnimation, Expiry, ProjectileBody, Explosive>(count, write);
+  else
+    world.createBatch<Position, Velocity, Age, SpriteAnimation, Expiry, ProjectileBody>(count, write);
+}
+
+void ProjectileManager::writeBatchRows(ChunkView chunk, size_t firstRow, size_t rowCount, size_t batchIndex,
+  const float* xs, const float* ys, const float* speeds, const float* ages)
+{
+  Position* position = chunk.get<Position>() + firstRow;
+  Velocity* velocity = chunk.get<Velocity>() + firstRow;
+  Age* age = chunk.get<Age>() + firstRow;
+  SpriteAnimation* sprite = chunk.get<SpriteAnimation>() + firstRow;
+  Expiry* expiry = chunk.get<Expiry>() + firstRow;
+  ProjectileBody* body = chunk.get<ProjectileBody>() + firstRow;
+  for (size_t r = 0; r < rowCount; r++)
+  {
+    size_t i = batchIndex + r;
+    float velX = batchCosines[i] * speeds[i];
+    float velY = batchSines[i] * speeds[i];
+    position[r] = Position{ xs[i] + velX * ages[i], ys[i] + velY * ages[i] };
+    velocity[r] = Velocity{ velX, velY };
+    age[r] = Age{ ages[i] };
+    // Emitters run after the integrate system, so the frame for the age is set here
+    sprite[r] = SpriteAnimation{ 10.0f, ProjectileSpriteSheet::frameCount,
+      (int)(ages[i] * 10.0f) % ProjectileSpriteSheet::frameCount };
+    expiry[r] = Expiry{ 5.0f, 5.0f };
+    body[r] = ProjectileBody{ 0.08f };
+  }
+}
+
+void ProjectileManager::steerHoming(float deltaTime, EnemyManager* enemyManager)
+{
+  PROFILE_ZONE("Homing");
+  if (!enemyManager)
+    return;
+
+  // Gather the shots due a new target; no entity is created or destroyed until the end, so
+  // the component pointers stay valid
+  retargets.x.clear();
+  retargets.y.clear();
+  retargets.homing.clear();
+  world.forEachChunk<Position, Homing>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    Homing* homing = chunk.get<Homing>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+    {
+      Homing& h = homing[i];
+      // A shot that found nothing last time waits for its timer instead of asking every frame
+      h.retargetTimer -= deltaTime;
+      if (h.retargetTimer > 0.0f && (h.target.isNull() || enemyManager->isAlive(h.target)))
+        continue;
+      h.retargetTimer = std::max(h.retargetTimer + h.retargetInterval, 0.0f);
+      retargets.x.push_back(position[i].x);
+      retargets.y.push_back(position[i].y);
+      retargets.homing.push_back(&h);
+    }
+  });
+
+  size_t count = retargets.homing.size();
+  if (count > 0)
+  {
+    retargets.targets.resize(count);
+    enemyManager->prepareTargeting();
+    enemyManager->findNearestEnemies(retargets.x.data(), retargets.y.data(), count, retargets.targets.data());
+    for (size_t k = 0; k < count; k++)
+      retargets.homing[k]->target = retargets.targets[k];
+  }
 
-  projectiles.emplace_back(startX, startY, velX, velY);
+  // Rotate each velocity toward its target by at most turnRate * deltaTime
+  world.forEachChunk<Position, Velocity, Homing>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    Velocity* velocity = chunk.get<Velocity>();
+    const Homing* homing = chunk.get<Homing>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+    {
+      const Position* target = world.get<Position>(homing[i].target);
+      if (!target)
+        continue;
+
+      // Signed angle from the heading to the target: atan2(cross, dot)
+      float toX = target->x - position[i].x, toY = target->y - position[i].y;
+      Velocity& v = velocity[i];
+      float turn = FastMath::atan2(v.x * toY - v.y * toX, v.x * toX + v.y * toY);
+      float maxTurn = homing[i].turnRate * deltaTime;
+      turn = std::min(std::max(turn, -maxTurn), maxTurn);
+
+      float s, c;
+      FastMath::sinCos(turn, s, c);
+      v = Velocity{ v.x * c - v.y * s, v.x * s + v.y * c };
+    }
+  });
 }
 
 bool ProjectileManager::canShoot(float baseIntervalMs, float timingErrorPercent)
@@ -146,7 +333,7 @@ bool ProjectileManager::canShoot(float baseIntervalMs, float timingErrorPercent)
   // Calculate timing error
   // 2% error means interval can vary by ±2% (e.g., 200ms ±4ms = 196-204ms range)
   float errorRange = (timingErrorPercent / 100.0f) * baseIntervalMs;
-  float timingError = dis(gen) * errorRange;
+  float timingError = rng.uniform(-1.0f, 1.0f) * errorRange;
   float adjustedInterval = baseIntervalMs + timingError;
 
   return timeSinceLastShot.count() >= adjustedInterval;
@@ -159,115 +346,150 @@ void ProjectileManager::updateLastShotTime()
 
 void ProjectileManager::update(float deltaTime, EnemyManager* enemyManager)
 {
-  for (auto it = projectiles.begin(); it != projectiles.end();)
-  {
-    auto& proj = *it;
+  PROFILE_ZONE("Collision");
+  if (!enemyManager)
+    return;
+
+  // Swept over the whole frame (or since spawning, for younger projectiles), so fast shots
+  // and long frames cannot pass through an enemy. Enemies are destroyed as they die, which
+  // is safe while walking projectile chunks; projectiles that hit are destroyed once the
+  // walk is done. Projectiles are circles of their body radius; the snapshot's boxes grow by
+  // the largest one so the broadphase sees every enemy within reach.
+  float reach = 0.0f;
+  world.forEachChunk<ProjectileBody>([&](ChunkView chunk) {
+    const ProjectileBody* body = chunk.get<ProjectileBody>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+      reach = std::max(reach, body[i].radius);
+  });
+  enemyManager->prepareCollision(deltaTime, reach);
+  world.forEachChunk<Position, Velocity, Age, ProjectileBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const Velocity* velocity = chunk.get<Velocity>();
+    const Age* age = chunk.get<Age>();
+    const ProjectileBody* body = chunk.get<ProjectileBody>();
+    const Explosive* explosive = chunk.has<Explosive>() ? chunk.get<Explosive>() : nullptr;
+    const Entity* entities = chunk.entities();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
+    {
+      float travelled = std::min(deltaTime, age[i].seconds);
+      bool hit = explosive ?
+        enemyManager->sweepExplosive(position[i].x, position[i].y, velocity[i].x, velocity[i].y, travelled,
+          body[i].radius, explosive[i].radius, explosive[i].damage) :
+        enemyManager->sweepProjectile(position[i].x, position[i].y, velocity[i].x, velocity[i].y, travelled,
+          body[i].radius);
+      if (hit)
+        world.destroyDeferred(entities[i]);
+    }
+  });
+  world.flushDestroyed();
+}
 
-    proj.x += proj.velX * deltaTime;
-    proj.y += proj.velY * deltaTime;
-    proj.life += deltaTime;
+void ProjectileManager::render(std::shared_ptr<Shader> shader)
+{
+  PROFILE_ZONE("Projectile render");
 
-    // Update animation frame (change frame every 0.1 seconds)
-    proj.frame = (int)(proj.life * 10.0f) % 4; // 4 frames, cycle every 0.4 seconds
+  if (renderMode == ProjectileRenderMode::Sprites)
+    renderSprites(shader);
+  else
+    renderQuads(shader);
+}
 
-    // Check collision with enemies if enemy manager is provided
-    bool hitEnemy = false;
-    if (enemyManager)
-    {
-      hitEnemy = enemyManager->checkProjectileCollisions(proj.x, proj.y, 0.08f);
-    }
+void ProjectileManager::renderSprites(std::shared_ptr<Shader> shader)
+{
+  size_t count = getProjectileCount();
+  if (count == 0) return;
 
-    // Remove projectiles that hit enemies, are off-screen, or too old
-    if (hitEnemy ||
-      proj.x < -5.0f || proj.x > 5.0f ||
-      proj.y < -5.0f || proj.y > 5.0f ||
-      proj.life > 5.0f)
-    {
-      it = projectiles.erase(it);
-    }
-    else
+  shader->use();
+
+  // Pack one vertex per projectile
+  spriteVertices.resize(count * 3);
+  float* out = spriteVertices.data();
+  world.forEachChunk<Position, SpriteAnimation, ProjectileBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const SpriteAnimation* sprite = chunk.get<SpriteAnimation>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++)
     {
-      ++it;
+      *out++ = position[i].x;
+      *out++ = position[i].y;
+      *out++ = (float)sprite[i].frame;
     }
+  });
+
+  glBindBuffer(GL_ARRAY_BUFFER, spriteVBO);
+  size_t bytes = spriteVertices.size() * sizeof(float);
+  if (count > spriteBufferCapacity)
+  {
+    // Grow geometrically so steady-state frames only do a sub-data upload
+    spriteBufferCapacity = std::max(count, spriteBufferCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, spriteBufferCapacity * 3 * sizeof(float), nullptr, GL_STREAM_DRAW);
   }
-}
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, spriteVertices.data());
 
-void ProjectileManager::getFrameCoords(int frame, float coords[8])
-{
-  // Sprite sheet: 64x64, 2x2 grid, each frame 32x32
-  // Frame layout:
-  // 0 | 1
-  // -----
-  // 2 | 3
-
-  float frameWidth = 0.5f;  // 32/64 = 0.5
-  float frameHeight = 0.5f; // 32/64 = 0.5
-
-  int col = frame % 2;       // 0 or 1
-  int row = frame / 2;       // 0 or 1
-
-  float left = col * frameWidth;
-  float right = left + frameWidth;
-  float top = 1.0f - (row * frameHeight);      // Flip Y for OpenGL
-  float bottom = top - frameHeight;
-
-  // Texture coordinates for quad (top-right, bottom-right, bottom-left, top-left)
-  coords[0] = right; coords[1] = top;      // top right
-  coords[2] = right; coords[3] = bottom;   // bottom right  
-  coords[4] = left;  coords[5] = bottom;   // bottom left
-  coords[6] = left;  coords[7] = top;      // top left
+  // Bind projectile texture
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  TextureSampler::bind(samplerProfile, 0);
+  TextureLoader::applyBlendFunc(texture);
+  shader->setInt("projectileTexture", 0);
+  shader->setFloat("halfSize", 0.08f);
+  shader->setInt("sheetColumns", ProjectileSpriteSheet::columns);
+  shader->setInt("sheetRows", ProjectileSpriteSheet::rows);
+
+  // 4-vertex strip per instance, all projectiles in one draw call
+  glBindVertexArray(spriteVAO);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
 }
 
-void ProjectileManager::render(std::shared_ptr<Shader> shader)
+void ProjectileManager::renderQuads(std::shared_ptr<Shader> shader)
 {
+  size_t count = getProjectileCount();
+  if (count == 0) return;
+
   shader->use();
-  glBindVertexArray(VAO);
+
+  // Gather position and frame per projectile; the instances are built from them in one batch
+  InstanceScratch& scratch = quadScratch;
+  scratch.xy.resize(count * 2);
+  scratch.sizes.assign(count, 0.08f);   // Projectiles are drawn unrotated at a fixed size
+  scratch.frames.resize(count);
+  size_t written = 0;
+  world.forEachChunk<Position, SpriteAnimation, ProjectileBody>([&](ChunkView chunk) {
+    const Position* position = chunk.get<Position>();
+    const SpriteAnimation* sprite = chunk.get<SpriteAnimation>();
+    for (size_t i = 0, n = chunk.size(); i < n; i++, written++)
+    {
+      scratch.xy[written * 2] = position[i].x;
+      scratch.xy[written * 2 + 1] = position[i].y;
+      scratch.frames[written] = sprite[i].frame;
+    }
+  });
+
+  scratch.instances.resize(written);
+  buildSpriteInstances(Mat4::identity(), scratch.xy.data(), scratch.sizes.data(), scratch.frames.data(),
+    &ProjectileSpriteSheet::frame(0), scratch.instances.data(), written);
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  if (written > instanceCapacity)
+  {
+    // Grow geometrically so steady-state frames only do a sub-data upload
+    instanceCapacity = std::max(written, instanceCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+  }
+  glBufferSubData(GL_ARRAY_BUFFER, 0, written * sizeof(SpriteInstance), scratch.instances.data());
 
   // Bind projectile texture
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, texture);
+  TextureSampler::bind(samplerProfile, 0);
+  TextureLoader::applyBlendFunc(texture);
   shader->setInt("projectileTexture", 0);
 
-  for (const auto& proj : projectiles)
-  {
-    // Get texture coordinates for current frame
-    float frameCoords[8];
-    getFrameCoords(proj.frame, frameCoords);
-
-    // Update vertex buffer with new texture coordinates
-    float tempVertices[] = {
-      // positions        // texture coords (updated per frame)
-       0.08f,  0.08f, 0.0f,  frameCoords[0], frameCoords[1],  // top right
-       0.08f, -0.08f, 0.0f,  frameCoords[2], frameCoords[3],  // bottom right
-      -0.08f, -0.08f, 0.0f,  frameCoords[4], frameCoords[5],  // bottom left
-      -0.08f,  0.08f, 0.0f,  frameCoords[6], frameCoords[7]   // top left
-    };
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(tempVertices), tempVertices);
-
-    // Create transformation matrix
-    float transform[16];
-    float cosA = cos(0.0f);
-    float sinA = sin(0.0f);
-
-    // Initialize to identity matrix
-    for (int i = 0; i < 16; i++)
-      transform[i] = 0.0f;
-
-    // Set rotation + translation matrix values
-    transform[0] = cosA;   transform[1] = sinA;   transform[2] = 0.0f;  transform[3] = 0.0f;
-    transform[4] = -sinA;  transform[5] = cosA;   transform[6] = 0.0f;  transform[7] = 0.0f;
-    transform[8] = 0.0f;   transform[9] = 0.0f;   transform[10] = 1.0f; transform[11] = 0.0f;
-    transform[12] = proj.x; transform[13] = proj.y; transform[14] = 0.0f; transform[15] = 1.0f;
-
-    shader->setMatrix4fv("transform", transform);
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-  }
+  // All projectiles in one draw call
+  glBindVertexArray(VAO);
+  glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)written);
 }
 
 void ProjectileManager::clear()
 {
-  projectiles.clear();
+  world.destroyAll<ProjectileBody>();
 }
\ No newline at end of file
@@ -2,68 +2,129 @@
 
 #include <vector>
 #include <memory>
-#include <random>
 #include <chrono>
+#include "texture_sampler.h"
+#include "sprite_sheet.h"
+#include "transform_math.h"
+#include "ecs.h"
+#include "components.h"
+#include "rng.h"
 class Shader;
 class EnemyManager;
 
-struct Projectile {
-  float x, y;          // Position
-  float velX, velY;    // Velocity
-  float life;          // Time alive (for cleanup and animation)
-  int frame;           // Current animation frame (0-3)
-
-  Projectile(float startX, float startY, float vx, float vy);
+// How projectiles are submitted to the GPU
+enum class ProjectileRenderMode {
+  Quads,    // One 4-vertex quad per projectile, drawn instanced from a transform and frame UVs each
+  Sprites   // One (x, y, frame) vertex per projectile, expanded to a quad in the vertex shader
 };
 
+// Projectiles are World entities with Position, Velocity, Age, SpriteAnimation, Expiry and
+// ProjectileBody, plus Homing for guided shots and Explosive for shots that explode on impact;
+// movement, animation and expiry run as shared systems
+using ProjectileHandle = Entity;
+
 class ProjectileManager
 {
 public:
-  ProjectileManager();
+  explicit ProjectileManager(World& world);
   ~ProjectileManager();
 
   // Initialize OpenGL resources
   bool initialize(const char* texturePath);
 
+  // Initialize OpenGL resources with an already acquired texture (takes over that reference)
+  bool initializeWithTexture(unsigned int textureID);
+
   // Add a new projectile with spray and timing variations
-  void addProjectile(float startX, float startY, float angle, float speed = 1.5f);
+  ProjectileHandle addProjectile(float startX, float startY, float angle, float speed = 1.5f);
 
   // Add projectile with custom spray settings
-  void addProjectileWithSpray(float startX, float startY, float angle, float speed = 1.5f,
+  ProjectileHandle addProjectileWithSpray(float startX, float startY, float angle, float speed = 1.5f,
     float sprayPercent = 1.0f);
 
+  // Batch of projectiles from SoA arrays: origin, heading (radians), speed, and how long each
+  // has already been in flight (it starts that far along its path). With turn rates (radians
+  // per second) and retarget intervals the batch is homing; each shot flies straight until it
+  // picks its first target after its retarget delay (at the next steerHoming without delays),
+  // so a volley can spread its lookups over several frames. With blast radii and damages it is
+  // explosive.
+  void spawnBatch(size_t count, const float* xs, const float* ys, const float* angles, const float* speeds,
+    const float* ages, const float* turnRates = nullptr, const float* retargetIntervals = nullptr,
+    const float* retargetDelays = nullptr, const float* blastRadii = nullptr, const int* blastDamages = nullptr);
+
   // Check if enough time has passed for next shot (with timing error)
   bool canShoot(float baseIntervalMs = 200.0f, float timingErrorPercent = 2.0f);
 
   // Update the last shot time (call when actually shooting)
   void updateLastShotTime();
 
-  // Update all projectiles and check collisions
+  // Turns homing projectiles toward their targets, first retargeting the ones whose timer ran
+  // out or whose target died to the nearest live enemy (one batched lookup for all of them).
+  // Run it before movement.
+  void steerHoming(float deltaTime, EnemyManager* enemyManager);
+
+  // Per-frame projectile logic: destroys projectiles that hit an enemy anywhere along the
+  // path they travelled this frame (explosive ones damage everything around the impact)
   void update(float deltaTime, class EnemyManager* enemyManager = nullptr);
 
-  // Render all projectiles
+  // Render all projectiles (shader must match the current render mode)
   void render(std::shared_ptr<Shader> shader);
 
+  // Select quad or single-vertex sprite rendering
+  void setRenderMode(ProjectileRenderMode mode) { renderMode = mode; }
+  ProjectileRenderMode getRenderMode() const { return renderMode; }
+
+  // Filtering used when sampling the texture
+  void setSamplerProfile(SamplerProfile profile);
+  SamplerProfile getSamplerProfile() const { return samplerProfile; }
+
   // Get projectile count
-  size_t getProjectileCount() const { return projectiles.size(); }
+  size_t getProjectileCount() const { return world.count<ProjectileBody>(); }
+
+  // Whether a handle still refers to a live projectile; read its components through the World
+  bool isAlive(ProjectileHandle handle) const { return world.has<ProjectileBody>(handle); }
 
-  // Clear all projectiles
+  // Destroy all projectiles
   void clear();
 
 private:
-  std::vector<Projectile> projectiles;
+  World& world;
+
+  // Random number generation for spray and timing (the "projectiles" stream)
+  Rng rng;
 
-  // Random number generation for spray and timing
-  mutable std::random_device rd;
-  mutable std::mt19937 gen;
-  mutable std::uniform_real_distribution<float> dis;
+  // Per-batch heading scratch
+  std::vector<float> batchSines, batchCosines;
+
+  // Homing shots retargeting this frame: query points, their components and the answers
+  struct RetargetScratch {
+    std::vector<float> x, y;
+    std::vector<Homing*> homing;
+    std::vector<Entity> targets;
+  } retargets;
 
   // Timing for shot intervals
   std::chrono::steady_clock::time_point lastShotTime;
 
-  // OpenGL resources
+  // OpenGL resources: a unit quad, and in quad mode one SpriteInstance per projectile
   unsigned int VAO, VBO, EBO;
+  unsigned int instanceVBO;
+  size_t instanceCapacity;            // In projectiles
   unsigned int texture;
+  SamplerProfile samplerProfile;
+
+  // Quad mode render scratch, gathered per projectile before the instances are built in one batch
+  struct InstanceScratch {
+    std::vector<float> xy, sizes;
+    std::vector<int> frames;
+    std::vector<SpriteInstance> instances;
+  } quadScratch;
+
+  // Sprite mode resources: one instanced vertex per projectile
+  ProjectileRenderMode renderMode;
+  unsigned int spriteVAO, spriteVBO;
+  size_t spriteBufferCapacity;        // In projectiles
+  std::vector<float> spriteVertices;  // x, y, frame per projectile
 
   // Shader sources
   static const char* vertexShaderSource;
@@ -71,6 +132,10 @@ private:
 
   // Helper functions
   void setupMesh();
+  void setupSpriteMesh();
+  void writeBatchRows(ChunkView chunk, size_t firstRow, size_t rowCount, size_t batchIndex,
+    const float* xs, const float* ys, const float* speeds, const float* ages);
   unsigned int loadTexture(const char* path);
-  void getFrameCoords(int frame, float coords[8]);
+  void renderQuads(std::shared_ptr<Shader> shader);
+  void renderSprites(std::shared_ptr<Shader> shader);
 };
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "rng.h"
+#include "transform_math.h"   // LLAMA_MATH_SSE
+
+#include <random>
+
+#if LLAMA_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+  // Expands one 64-bit seed into well-mixed state words
+  uint64_t splitMix64(uint64_t& state)
+  {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  uint32_t mulHiLo(uint32_t a, uint32_t b, uint32_t& hi)
+  {
+    uint64_t product = (uint64_t)a * b;
+    hi = (uint32_t)(product >> 32);
+    return (uint32_t)product;
+  }
+
+  bool globalSeedSet = false;
+  uint64_t globalSeed = 0;
+}
+
+void Rng::reseed(uint64_t seed)
+{
+  // All-zero state is the one invalid xoshiro state; splitmix output never yields it in practice
+  uint64_t state = seed;
+  for (int i = 0; i < 4; i += 2)
+  {
+    uint64_t word = splitMix64(state);
+    s[i] = (uint32_t)word;
+    s[i + 1] = (uint32_t)(word >> 32);
+  }
+  for (int lane = 0; lane < 4; lane++)
+  {
+    for (int i = 0; i < 4; i += 2)
+    {
+      uint64_t word = splitMix64(state);
+      lanes[i][lane] = (uint32_t)word;
+      lanes[i + 1][lane] = (uint32_t)(word >> 32);
+    }
+  }
+}
+
+void Rng::fillUniform(float* out, size_t count, float lo, float hi)
+{
+  // xoshiro128+ per lane: its low bits are weak, but floats only use the top 24
+  size_t i = 0;
+  float scale = (hi - lo) * (1.0f / 16777216.0f);
+#if LLAMA_MATH_SSE
+  __m128i s0 = _mm_load_si128((const __m128i*)lanes[0]);
+  __m128i s1 = _mm_load_si128((const __m128i*)lanes[1]);
+  __m128i s2 = _mm_load_si128((const __m128i*)lanes[2]);
+  __m128i s3 = _mm_load_si128((const __m128i*)lanes[3]);
+  __m128 scaleVec = _mm_set1_ps(scale);
+  __m128 loVec = _mm_set1_ps(lo);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i result = _mm_add_epi32(s0, s3);
+    __m128i t = _mm_slli_epi32(s1, 9);
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, t);
+    s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+    // 24-bit integers convert exactly
+    __m128 unit = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+    _mm_storeu_ps(out + i, _mm_add_ps(loVec, _mm_mul_ps(unit, scaleVec)));
+  }
+  _mm_store_si128((__m128i*)lanes[0], s0);
+  _mm_store_si128((__m128i*)lanes[1], s1);
+  _mm_store_si128((__m128i*)lanes[2], s2);
+  _mm_store_si128((__m128i*)lanes[3], s3);
+#endif
+
+  // Same recurrence one lane at a time, so SSE and scalar builds produce identical output
+  for (; i < count; i++)
+  {
+    int lane = (int)(i & 3);
+    uint32_t* w0 = &lanes[0][lane];
+    uint32_t* w1 = &lanes[1][lane];
+    uint32_t* w2 = &lanes[2][lane];
+    uint32_t* w3 = &lanes[3][lane];
+    uint32_t result = *w0 + *w3;
+    uint32_t t = *w1 << 9;
+    *w2 ^= *w0;
+    *w3 ^= *w1;
+    *w1 ^= *w2;
+    *w0 ^= *w3;
+    *w2 ^= t;
+    *w3 = rotl(*w3, 11);
+    out[i] = lo + (result >> 8) * scale;
+  }
+}
+
+void PhiloxStream::block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+  const uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round < 10; round++)
+  {
+    uint32_t hi0, hi1;
+    uint32_t lo0 = mulHiLo(M0, c0, hi0);
+    uint32_t lo1 = mulHiLo(M1, c2, hi1);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += W0;
+    k1 += W1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+uint32_t PhiloxStream::at(uint64_t index) const
+{
+  // Counter = (block index, stream); each block yields four outputs
+  uint64_t blockIndex = index >> 2;
+  if (blockIndex != cachedBlock)
+  {
+    uint32_t counter[4] = { (uint32_t)blockIndex, (uint32_t)(blockIndex >> 32), (uint32_t)stream, (uint32_t)(stream >> 32) };
+    block(counter, key, cached);
+    cachedBlock = blockIndex;
+  }
+  return cached[index & 3];
+}
+
+namespace Random
+{
+  void setGlobalSeed(uint64_t seed)
+  {
+    globalSeed = seed;
+    globalSeedSet = true;
+  }
+
+  uint64_t getGlobalSeed()
+  {
+    if (!globalSeedSet)
+    {
+      std::random_device device;
+      setGlobalSeed(((uint64_t)device() << 32) | device());
+    }
+    return globalSeed;
+  }
+
+  uint64_t streamSeed(const char* name)
+  {
+    // FNV-1a of the name, mixed with the global seed
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char* c = name; *c; c++)
+      hash = (hash ^ (unsigned char)*c) * 0x100000001B3ull;
+
+    uint64_t state = getGlobalSeed() ^ hash;
+    return splitMix64(state);
+  }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Small, seedable random number generators for gameplay code.
+//
+//   Rng           xoshiro128** for scalar draws, plus a 4-lane xoshiro128+ bulk float fill
+//   PhiloxStream  counter-based Philox4x32-10: any draw can be computed from (seed, stream,
+//                 index) alone, so parallel workers need no shared state
+//
+// All streams derive from one global seed (Random::setGlobalSeed), so a run can be replayed.
+
+class Rng
+{
+public:
+  explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+  void reseed(uint64_t seed);
+
+  uint32_t next()
+  {
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+  }
+
+  // [0, 1) with 24 bits of precision
+  float nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+  // [lo, hi)
+  float uniform(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+
+  // [0, bound), without modulo bias worth worrying about (multiply-shift)
+  uint32_t below(uint32_t bound) { return (uint32_t)(((uint64_t)next() * bound) >> 32); }
+
+  bool chance(float probability) { return nextFloat() < probability; }
+
+  // count floats in [lo, hi) from four interleaved generators (SSE2 when available). This is a
+  // separate sequence from next(), but just as reproducible.
+  void fillUniform(float* out, size_t count, float lo, float hi);
+
+private:
+  uint32_t s[4];
+  alignas(16) uint32_t lanes[4][4];   // Bulk state: lanes[word][lane]
+
+  static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+};
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+class PhiloxStream
+{
+public:
+  PhiloxStream(uint64_t seed, uint64_t stream) : key{ (uint32_t)seed, (uint32_t)(seed >> 32) }, stream(stream) {}
+
+  // One block of four outputs for a counter and key
+  static void block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+  // The index-th output of this stream (random access; the last block is cached, so
+  // ascending indices cost one block per four outputs)
+  uint32_t at(uint64_t index) const;
+  float floatAt(uint64_t index) const { return (at(index) >> 8) * (1.0f / 16777216.0f); }
+
+  // Sequential use
+  uint32_t next() { return at(position++); }
+  float nextFloat() { return floatAt(position++); }
+  void seek(uint64_t index) { position = index; }
+
+private:
+  uint32_t key[2];
+  uint64_t stream;
+  uint64_t position = 0;
+
+  mutable uint64_t cachedBlock = ~0ull;
+  mutable uint32_t cached[4];
+};
+
+namespace Random
+{
+  // Seed every stream is derived from. Picked from std::random_device on first use unless set
+  // beforehand (the game reads LLAMA_SEED at startup).
+  void setGlobalSeed(uint64_t seed);
+  uint64_t getGlobalSeed();
+
+  // Seed of a named stream: the same name and global seed always give the same sequence,
+  // whatever order streams are created in
+  uint64_t streamSeed(const char* name);
+
+  inline Rng makeRng(const char* name) { return Rng(streamSeed(name)); }
+  inline PhiloxStream makePhilox(const char* name) { return PhiloxStream(getGlobalSeed(), streamSeed(name)); }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Stable reference to a SlotMap element. A handle whose element was removed (even if the
+// slot has been reused since) simply fails to resolve. The type parameter keeps handles of
+// different element types apart.
+template <typename T>
+struct SlotHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0;   // 0 is never issued, so a default handle is null
+
+  bool isNull() const { return generation == 0; }
+  bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+  bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Generational slot map: O(1) insert, remove and lookup, with the values packed in a dense
+// array for iteration. Removal moves the last value into the gap, so dense order is not
+// stable; only handles are.
+template <typename T>
+class SlotMap
+{
+public:
+  using Handle = SlotHandle<T>;
+
+  template <typename... Args>
+  Handle emplace(Args&&... args)
+  {
+    uint32_t slotIndex;
+    if (freeHead != NONE)
+    {
+      slotIndex = freeHead;
+      freeHead = slots[slotIndex].denseOrNextFree;
+    }
+    else
+    {
+      slotIndex = (uint32_t)slots.size();
+      slots.push_back(Slot{ NONE, 1 });
+    }
+
+    Slot& slot = slots[slotIndex];
+    slot.denseOrNextFree = (uint32_t)values.size();
+    values.emplace_back(std::forward<Args>(args)...);
+    denseToSlot.push_back(slotIndex);
+    return Handle{ slotIndex, slot.generation };
+  }
+
+  Handle insert(const T& value) { return emplace(value); }
+
+  // Returns false if the handle was already stale
+  bool remove(Handle handle)
+  {
+    if (!contains(handle))
+      return false;
+    removeAt(slots[handle.index].denseOrNextFree);
+    return true;
+  }
+
+  // Remove by dense position (for use while iterating by index: the last value moves here)
+  void removeAt(size_t denseIndex)
+  {
+    uint32_t slotIndex = denseToSlot[denseIndex];
+    size_t last = values.size() - 1;
+    if (denseIndex != last)
+    {
+      values[denseIndex] = std::move(values[last]);
+      denseToSlot[denseIndex] = denseToSlot[last];
+      slots[denseToSlot[denseIndex]].denseOrNextFree = (uint32_t)denseIndex;
+    }
+    values.pop_back();
+    denseToSlot.pop_back();
+
+    // Retire the generation so outstanding handles go stale; skip 0 on wrap-around
+    Slot& slot = slots[slotIndex];
+    slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+    slot.denseOrNextFree = freeHead;
+    freeHead = slotIndex;
+  }
+
+  bool contains(Handle handle) const
+  {
+    return handle.index < slots.size() && handle.generation != 0 && slots[handle.index].generation == handle.generation;
+  }
+
+  // nullptr for stale handles. Valid until the next insert or remove.
+  T* get(Handle handle) { return contains(handle) ? &values[slots[handle.index].denseOrNextFree] : nullptr; }
+  const T* get(Handle handle) const { return contains(handle) ? &values[slots[handle.index].denseOrNextFree] : nullptr; }
+
+  // Handle of the value at a dense position
+  Handle handleAt(size_t denseIndex) const
+  {
+    uint32_t slotIndex = denseToSlot[denseIndex];
+    return Handle{ slotIndex, slots[slotIndex].generation };
+  }
+
+  // Dense access and iteration
+  T& operator[](size_t denseIndex) { return values[denseIndex]; }
+  const T& operator[](size_t denseIndex) const { return values[denseIndex]; }
+  typename std::vector<T>::iterator begin() { return values.begin(); }
+  typename std::vector<T>::iterator end() { return values.end(); }
+  typename std::vector<T>::const_iterator begin() const { return values.begin(); }
+  typename std::vector<T>::const_iterator end() const { return values.end(); }
+  const T* data() const { return values.data(); }
+
+  size_t size() const { return values.size(); }
+  bool empty() const { return values.empty(); }
+
+  void reserve(size_t count)
+  {
+    values.reserve(count);
+    denseToSlot.reserve(count);
+    slots.reserve(count);
+  }
+
+  // Remove everything; outstanding handles go stale
+  void clear()
+  {
+    while (!values.empty())
+      removeAt(values.size() - 1);
+  }
+
+private:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  struct Slot {
+    uint32_t denseOrNextFree;   // Dense index while occupied, next free slot otherwise
+    uint32_t generation;
+  };
+
+  std::vector<T> values;
+  std::vector<uint32_t> denseToSlot;
+  std::vector<Slot> slots;
+  uint32_t freeHead = NONE;
+};
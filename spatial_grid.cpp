@@ -0,0 +1,76 @@
+#include "spatial_grid.h"
+
+void SpatialGrid::build(const float* minX, const float* minY, const float* maxX, const float* maxY, size_t count)
+{
+  items.clear();
+  cellStart.clear();
+  if (count == 0)
+    return;
+
+  float lowX = minX[0], lowY = minY[0], highX = maxX[0], highY = maxY[0];
+  for (size_t i = 1; i < count; i++)
+  {
+    lowX = std::min(lowX, minX[i]);
+    lowY = std::min(lowY, minY[i]);
+    highX = std::max(highX, maxX[i]);
+    highY = std::max(highY, maxY[i]);
+  }
+
+  // Grow the cells rather than the grid when the boxes are spread far apart
+  float extent = std::max(highX - lowX, highY - lowY);
+  cell = std::max(cellSize, extent / MAX_CELLS_PER_AXIS);
+  originX = lowX;
+  originY = lowY;
+  columns = std::min(std::max((int)std::ceil((highX - lowX) / cell), 1), MAX_CELLS_PER_AXIS);
+  rows = std::min(std::max((int)std::ceil((highY - lowY) / cell), 1), MAX_CELLS_PER_AXIS);
+
+  // Counting sort: count per cell, prefix sum, then fill
+  size_t cellCount = (size_t)columns * rows;
+  cellStart.assign(cellCount + 1, 0);
+  for (size_t i = 0; i < count; i++)
+  {
+    int x0, y0, x1, y1;
+    cellRange(minX[i], minY[i], maxX[i], maxY[i], x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; cy++)
+      for (int cx = x0; cx <= x1; cx++)
+        cellStart[(size_t)cy * columns + cx + 1]++;
+  }
+  for (size_t c = 0; c < cellCount; c++)
+    cellStart[c + 1] += cellStart[c];
+
+  size_t entries = cellStart[cellCount];
+  items.resize(entries);
+  boxMinX.resize(entries);
+  boxMinY.resize(entries);
+  boxMaxX.resize(entries);
+  boxMaxY.resize(entries);
+  fillCursor.assign(cellStart.begin(), cellStart.end() - 1);
+  for (size_t i = 0; i < count; i++)
+  {
+    int x0, y0, x1, y1;
+    cellRange(minX[i], minY[i], maxX[i], maxY[i], x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; cy++)
+    {
+      for (int cx = x0; cx <= x1; cx++)
+      {
+        uint32_t entry = fillCursor[(size_t)cy * columns + cx]++;
+        items[entry] = (uint32_t)i;
+        boxMinX[entry] = minX[i];
+        boxMinY[entry] = minY[i];
+        boxMaxX[entry] = maxX[i];
+        boxMaxY[entry] = maxY[i];
+      }
+    }
+  }
+}
+
+bool SpatialGrid::cellRange(float minX, float minY, float maxX, float maxY, int& x0, int& y0, int& x1, int& y1) const
+{
+  if (maxX < originX || maxY < originY || minX > originX + columns * cell || minY > originY + rows * cell)
+    return false;
+  x0 = columnAt(minX - originX);
+  y0 = rowAt(minY - originY);
+  x1 = columnAt(maxX - originX);
+  y1 = rowAt(maxY - originY);
+  return true;
+}
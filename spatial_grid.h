@@ -0,0 +1,238 @@
+#pragma once
+
+#include "box_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Where the segment (x0, y0) -> (x1, y1) is inside the box, as parameters in [0, 1] along it
+// (slab test, boundaries count as inside). False if it never is.
+inline bool segmentBoxOverlap(float x0, float y0, float x1, float y1,
+  float minX, float minY, float maxX, float maxY, float& tEnter, float& tExit)
+{
+  float from[2] = { x0, y0 };
+  float delta[2] = { x1 - x0, y1 - y0 };
+  float lo[2] = { minX, minY };
+  float hi[2] = { maxX, maxY };
+
+  float t0 = 0.0f, t1 = 1.0f;
+  for (int axis = 0; axis < 2; axis++)
+  {
+    if (delta[axis] == 0.0f)
+    {
+      if (from[axis] < lo[axis] || from[axis] > hi[axis])
+        return false;
+      continue;
+    }
+    float inverse = 1.0f / delta[axis];
+    float a = (lo[axis] - from[axis]) * inverse;
+    float b = (hi[axis] - from[axis]) * inverse;
+    if (a > b) std::swap(a, b);
+    t0 = std::max(t0, a);
+    t1 = std::min(t1, b);
+    if (t0 > t1)
+      return false;
+  }
+
+  tEnter = t0;
+  tExit = t1;
+  return true;
+}
+
+// Squared distance from a point to a box, 0 inside it
+inline float pointBoxDistanceSquared(float x, float y, float minX, float minY, float maxX, float maxY)
+{
+  float dx = std::max(std::max(minX - x, x - maxX), 0.0f);
+  float dy = std::max(std::max(minY - y, y - maxY), 0.0f);
+  return dx * dx + dy * dy;
+}
+
+// Squared distance from a point to the segment (x0, y0) -> (x1, y1)
+inline float pointSegmentDistanceSquared(float x, float y, float x0, float y0, float x1, float y1)
+{
+  float dx = x1 - x0, dy = y1 - y0;
+  float lengthSquared = dx * dx + dy * dy;
+  float t = lengthSquared > 0.0f ? std::min(std::max(((x - x0) * dx + (y - y0) * dy) / lengthSquared, 0.0f), 1.0f) : 0.0f;
+  float ex = x0 + dx * t - x, ey = y0 + dy * t - y;
+  return ex * ex + ey * ey;
+}
+
+// Squared distance from the segment (x0, y0) -> (x1, y1) to a box, 0 if they touch. Apart,
+// a segment and a convex polygon are closest at an endpoint of the segment or a corner of
+// the polygon, so those six candidates cover it.
+inline float segmentBoxDistanceSquared(float x0, float y0, float x1, float y1,
+  float minX, float minY, float maxX, float maxY)
+{
+  if (x0 == x1 && y0 == y1)
+    return pointBoxDistanceSquared(x0, y0, minX, minY, maxX, maxY);
+
+  float tEnter, tExit;
+  if (segmentBoxOverlap(x0, y0, x1, y1, minX, minY, maxX, maxY, tEnter, tExit))
+    return 0.0f;
+
+  float best = std::min(pointBoxDistanceSquared(x0, y0, minX, minY, maxX, maxY),
+    pointBoxDistanceSquared(x1, y1, minX, minY, maxX, maxY));
+  best = std::min(best, pointSegmentDistanceSquared(minX, minY, x0, y0, x1, y1));
+  best = std::min(best, pointSegmentDistanceSquared(maxX, minY, x0, y0, x1, y1));
+  best = std::min(best, pointSegmentDistanceSquared(minX, maxY, x0, y0, x1, y1));
+  best = std::min(best, pointSegmentDistanceSquared(maxX, maxY, x0, y0, x1, y1));
+  return best;
+}
+
+// Uniform grid over axis-aligned boxes, rebuilt from scratch whenever the boxes change (a
+// counting sort, O(boxes + cells)). It covers the bounds of the boxes it was built from.
+// Items are indices into the caller's box arrays, and an item overlapping several cells is
+// listed in each of them, so queries can report it more than once. Each cell also keeps a
+// copy of its boxes, so queries hand out contiguous BoxSpans for BoxKernel.
+class SpatialGrid
+{
+public:
+  static constexpr int MAX_CELLS_PER_AXIS = 256;
+
+  explicit SpatialGrid(float cellSize = 0.3f) : cellSize(cellSize) {}
+
+  // Preferred cell size; cells grow when the bounds would need more than MAX_CELLS_PER_AXIS
+  void setCellSize(float size) { cellSize = size; }
+
+  void build(const float* minX, const float* minY, const float* maxX, const float* maxY, size_t count);
+
+  bool empty() const { return items.empty(); }
+
+  // Cells in row-major order, for walking everything cell by cell (boxes close together are
+  // close in memory); a cell's span may be empty
+  size_t getCellCount() const { return items.empty() ? 0 : (size_t)columns * rows; }
+  BoxSpan getCell(size_t index) const { return span(cellStart[index], cellStart[index + 1]); }
+
+  // Storage layout, for callers keeping per-box data in the grid's order: cells are row-major
+  // (getColumns() per row), cell i's entries are [getCellBegin(i), getCellBegin(i + 1)) and
+  // entry e holds item getItems()[e]
+  int getColumns() const { return columns; }
+  int getRows() const { return rows; }
+  uint32_t getCellBegin(size_t index) const { return cellStart[index]; }
+  const uint32_t* getItems() const { return items.data(); }
+  size_t getEntryCount() const { return items.size(); }
+
+  // Calls fn(const BoxSpan& boxes) for every non-empty cell overlapping the box
+  template <typename Fn>
+  void queryBox(float minX, float minY, float maxX, float maxY, Fn&& fn) const
+  {
+    if (items.empty())
+      return;
+    int x0, y0, x1, y1;
+    if (!cellRange(minX, minY, maxX, maxY, x0, y0, x1, y1))
+      return;
+    for (int cy = y0; cy <= y1; cy++)
+    {
+      for (int cx = x0; cx <= x1; cx++)
+      {
+        size_t cell = (size_t)cy * columns + cx;
+        uint32_t first = cellStart[cell], last = cellStart[cell + 1];
+        if (first != last)
+          fn(span(first, last));
+      }
+    }
+  }
+
+  // Calls fn(const BoxSpan& boxes) for the non-empty cell containing (x, y), then for the
+  // non-empty ones of the eight around it; fn returns false to stop. With cells at least r
+  // wide, every box within r of the point is in one of them.
+  template <typename Fn>
+  void queryNeighbours(float x, float y, Fn&& fn) const
+  {
+    static constexpr int RING_X[9] = { 0, -1, 0, 1, -1, 1, -1, 0, 1 };
+    static constexpr int RING_Y[9] = { 0, -1, -1, -1, 0, 0, 1, 1, 1 };
+    if (items.empty())
+      return;
+    int cx = columnAt(x - originX);
+    int cy = rowAt(y - originY);
+    for (int k = 0; k < 9; k++)
+    {
+      int nx = cx + RING_X[k], ny = cy + RING_Y[k];
+      if (nx < 0 || nx >= columns || ny < 0 || ny >= rows)
+        continue;
+      size_t index = (size_t)ny * columns + nx;
+      uint32_t first = cellStart[index], last = cellStart[index + 1];
+      if (first != last && !fn(span(first, last)))
+        return;
+    }
+  }
+
+  // Walks the cells the segment (x0, y0) -> (x1, y1) crosses, in order along it, calling
+  // fn(const BoxSpan& boxes, float exit) for each non-empty one, where exit is
+  // the segment parameter at which the walk leaves that cell. fn returns false to stop.
+  template <typename Fn>
+  void querySegment(float x0, float y0, float x1, float y1, Fn&& fn) const
+  {
+    if (items.empty())
+      return;
+    float tEnter, tExit;
+    if (!segmentBoxOverlap(x0, y0, x1, y1, originX, originY, originX + columns * cell, originY + rows * cell, tEnter, tExit))
+      return;
+
+    float dx = x1 - x0, dy = y1 - y0;
+    int cx = columnAt(x0 + dx * tEnter - originX);
+    int cy = rowAt(y0 + dy * tEnter - originY);
+
+    // Amanatides-Woo: parameter of the next vertical and horizontal cell boundary
+    int stepX = dx > 0.0f ? 1 : -1;
+    int stepY = dy > 0.0f ? 1 : -1;
+    float nextX = dx != 0.0f ? (originX + (cx + (dx > 0.0f ? 1 : 0)) * cell - x0) / dx : INFINITY;
+    float nextY = dy != 0.0f ? (originY + (cy + (dy > 0.0f ? 1 : 0)) * cell - y0) / dy : INFINITY;
+    float deltaX = dx != 0.0f ? cell / std::fabs(dx) : INFINITY;
+    float deltaY = dy != 0.0f ? cell / std::fabs(dy) : INFINITY;
+
+    for (int steps = columns + rows; steps >= 0; steps--)
+    {
+      float exit = std::min(std::min(nextX, nextY), tExit);
+      size_t index = (size_t)cy * columns + cx;
+      uint32_t first = cellStart[index], last = cellStart[index + 1];
+      if (first != last && !fn(span(first, last), exit))
+        return;
+      if (exit >= tExit)
+        return;
+
+      if (nextX < nextY)
+      {
+        cx += stepX;
+        nextX += deltaX;
+      }
+      else
+      {
+        cy += stepY;
+        nextY += deltaY;
+      }
+      if (cx < 0 || cx >= columns || cy < 0 || cy >= rows)
+        return;
+    }
+  }
+
+private:
+  float cellSize;
+
+  // Layout of the last build
+  float originX = 0.0f, originY = 0.0f;
+  float cell = 1.0f;
+  int columns = 0, rows = 0;
+
+  std::vector<uint32_t> cellStart;   // Cell i's items are items[cellStart[i], cellStart[i + 1])
+  std::vector<uint32_t> items;
+  std::vector<float> boxMinX, boxMinY, boxMaxX, boxMaxY;   // Parallel to items
+  std::vector<uint32_t> fillCursor;   // Build scratch
+
+  BoxSpan span(uint32_t first, uint32_t last) const
+  {
+    return BoxSpan{ boxMinX.data() + first, boxMinY.data() + first, boxMaxX.data() + first, boxMaxY.data() + first,
+      items.data() + first, (size_t)(last - first) };
+  }
+
+  // Cell of an offset from the origin, clamped to the grid. Clamping in float before
+  // truncating equals flooring then clamping, without a floor call per coordinate.
+  int columnAt(float offset) const { return (int)std::min(std::max(offset / cell, 0.0f), (float)(columns - 1)); }
+  int rowAt(float offset) const { return (int)std::min(std::max(offset / cell, 0.0f), (float)(rows - 1)); }
+
+  // Cells overlapped by a box, clamped to the grid; false if the box is outside it
+  bool cellRange(float minX, float minY, float maxX, float maxY, int& x0, int& y0, int& x1, int& y1) const;
+};
@@ -0,0 +1,108 @@
+#include "sprite_sheet.h"
+#include "asset_pack.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+  // Append the frames of a uniform grid
+  bool appendGrid(int cols, int rows, int frameCount, std::vector<FrameUV>& out)
+  {
+    if (frameCount == 0)
+      frameCount = cols * rows;
+    if (cols <= 0 || rows <= 0 || frameCount <= 0 || frameCount > cols * rows)
+      return false;
+
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+      int col = frame % cols;
+      int row = frame / cols;
+      out.push_back(SpriteSheetDetail::rectUV((float)col / cols, (float)row / rows, 1.0f / cols, 1.0f / rows));
+    }
+    return true;
+  }
+}
+
+bool RuntimeSpriteSheet::setGrid(int cols, int rows, int frameCount)
+{
+  std::vector<FrameUV> grid;
+  if (!appendGrid(cols, rows, frameCount, grid))
+    return false;
+
+  frames = std::move(grid);
+  return true;
+}
+
+bool RuntimeSpriteSheet::parse(const std::string& text)
+{
+  std::vector<FrameUV> parsed;
+  float sheetWidth = 0.0f, sheetHeight = 0.0f;
+
+  std::istringstream lines(text);
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line))
+  {
+    lineNumber++;
+    size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command))
+      continue; // Blank line
+
+    bool valid = false;
+    if (command == "grid")
+    {
+      int cols = 0, rows = 0, frameCount = 0;
+      words >> cols >> rows;
+      if (!(words >> frameCount))
+        frameCount = 0;
+      valid = appendGrid(cols, rows, frameCount, parsed);
+    }
+    else if (command == "size")
+    {
+      valid = (bool)(words >> sheetWidth >> sheetHeight) && sheetWidth > 0.0f && sheetHeight > 0.0f;
+    }
+    else if (command == "frame")
+    {
+      float x, y, width, height;
+      valid = (bool)(words >> x >> y >> width >> height) && sheetWidth > 0.0f && width > 0.0f && height > 0.0f;
+      if (valid)
+        parsed.push_back(SpriteSheetDetail::rectUV(x / sheetWidth, y / sheetHeight, width / sheetWidth, height / sheetHeight));
+    }
+
+    if (!valid)
+    {
+      std::cout << "Invalid sprite sheet line " << lineNumber << ": " << line << std::endl;
+      return false;
+    }
+  }
+
+  if (parsed.empty())
+    return false;
+  frames = std::move(parsed);
+  return true;
+}
+
+bool RuntimeSpriteSheet::loadFile(const std::string& path)
+{
+  if (const AssetPack* pack = AssetPack::getMounted())
+  {
+    AssetView view = pack->find(path);
+    if (view.isValid())
+      return parse(std::string((const char*)view.data, view.size));
+  }
+
+  std::ifstream file(path);
+  if (!file)
+  {
+    std::cout << "Failed to open sprite sheet: " << path << std::endl;
+    return false;
+  }
+  return parse(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Texture coordinates of one frame in sprite quad vertex order:
+// top right, bottom right, bottom left, top left (u, v pairs)
+struct FrameUV {
+  float coords[8];
+};
+
+namespace SpriteSheetDetail
+{
+  // UVs of a rectangle given in sheet fractions with the origin at the top left
+  constexpr FrameUV rectUV(float left, float top, float width, float height)
+  {
+    float right = left + width;
+    float glTop = 1.0f - top;             // Flip Y for OpenGL
+    float glBottom = glTop - height;
+    return FrameUV{ { right, glTop, right, glBottom, left, glBottom, left, glTop } };
+  }
+
+  template <int Cols, int Rows, int Frames>
+  constexpr std::array<FrameUV, Frames> buildGrid()
+  {
+    std::array<FrameUV, Frames> table{};
+    for (int frame = 0; frame < Frames; frame++)
+    {
+      int col = frame % Cols;
+      int row = frame / Cols;
+      table[frame] = rectUV((float)col / Cols, (float)row / Rows, 1.0f / Cols, 1.0f / Rows);
+    }
+    return table;
+  }
+}
+
+// Uniform grid sheet known at compile time. Frames run row by row from the top left,
+// and the UV table is built by the compiler, so a frame lookup is a single index.
+template <int Cols, int Rows, int Frames = Cols * Rows>
+class SpriteSheet
+{
+public:
+  static_assert(Cols > 0 && Rows > 0, "SpriteSheet needs at least one cell");
+  static_assert(Frames > 0 && Frames <= Cols * Rows, "SpriteSheet frames must fit in the grid");
+
+  static constexpr int columns = Cols;
+  static constexpr int rows = Rows;
+  static constexpr int frameCount = Frames;
+
+  // UVs of a frame, 0 <= index < frameCount
+  static constexpr const FrameUV& frame(int index) { return table[index]; }
+
+private:
+  static constexpr std::array<FrameUV, Frames> table = SpriteSheetDetail::buildGrid<Cols, Rows, Frames>();
+};
+
+// Llama and enemy dinosaurs: 120x120, 24x24 frames, last cell unused
+//   0  | 1  | 2  | 3  | 4
+//   5  | 6  | 7  | 8  | 9
+//   10 | 11 | 12 | 13 | 14
+//   15 | 16 | 17 | 18 | 19
+//   20 | 21 | 22 | 23 | --
+using DinoSpriteSheet = SpriteSheet<5, 5, 24>;
+
+// Projectiles: 64x64, 32x32 frames
+using ProjectileSpriteSheet = SpriteSheet<2, 2, 4>;
+
+// Sheet described by data. Text format, one command per line ('#' starts a comment):
+//   grid <cols> <rows> [frames]      uniform grid, like SpriteSheet
+//   size <width> <height>            sheet size in pixels, required before "frame"
+//   frame <x> <y> <width> <height>   one frame in pixels, origin at the top left
+class RuntimeSpriteSheet
+{
+public:
+  // Replace the frames with a uniform grid
+  bool setGrid(int cols, int rows, int frameCount = 0);
+
+  // Replace the frames from a descriptor; prints the offending line on error
+  bool parse(const std::string& text);
+
+  // Parse a descriptor from the mounted asset pack or from disk
+  bool loadFile(const std::string& path);
+
+  int getFrameCount() const { return (int)frames.size(); }
+
+  // UVs of a frame, 0 <= index < getFrameCount()
+  const FrameUV& frame(int index) const { return frames[index]; }
+
+private:
+  std::vector<FrameUV> frames;
+};
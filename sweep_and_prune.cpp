@@ -0,0 +1,84 @@
+#include "sweep_and_prune.h"
+
+#include <algorithm>
+
+namespace
+{
+  const uint32_t NONE = 0xFFFFFFFFu;
+}
+
+void SweepAndPrune::update(const uint32_t* keys, const float* minX, const float* minY, const float* maxX, const float* maxY, size_t count)
+{
+  // Where each key is this frame
+  uint32_t keyBound = 0;
+  for (size_t i = 0; i < count; i++)
+    keyBound = std::max(keyBound, keys[i] + 1);
+  for (const Entry& entry : order)
+    keyBound = std::max(keyBound, entry.key + 1);
+  itemOfKey.assign(keyBound, NONE);
+  for (size_t i = 0; i < count; i++)
+    itemOfKey[keys[i]] = (uint32_t)i;
+
+  // Keep surviving boxes in last frame's order with fresh edges, then append the new ones
+  placed.assign(count, 0);
+  size_t kept = 0;
+  for (const Entry& entry : order)
+  {
+    uint32_t item = itemOfKey[entry.key];
+    if (item == NONE || placed[item])
+      continue;
+    placed[item] = 1;
+    order[kept++] = Entry{ minX[item], entry.key, item };
+  }
+  order.resize(kept);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!placed[i])
+      order.push_back(Entry{ minX[i], keys[i], (uint32_t)i });
+  }
+
+  // Insertion sort the coherent part, sort the newcomers, merge
+  size_t swaps = 0;
+  for (size_t i = 1; i < kept; i++)
+  {
+    Entry entry = order[i];
+    size_t j = i;
+    for (; j > 0 && order[j - 1].minX > entry.minX; j--)
+      order[j] = order[j - 1];
+    order[j] = entry;
+    swaps += i - j;
+  }
+  lastSwaps = swaps;
+  auto byMinX = [](const Entry& a, const Entry& b) { return a.minX < b.minX; };
+  if (kept < order.size())
+  {
+    std::sort(order.begin() + kept, order.end(), byMinX);
+    std::inplace_merge(order.begin(), order.begin() + kept, order.end(), byMinX);
+  }
+
+  sortedMinX.resize(count);
+  sortedMaxX.resize(count);
+  sortedMinY.resize(count);
+  sortedMaxY.resize(count);
+  sortedItems.resize(count);
+  widest = 0.0f;
+  for (size_t i = 0; i < count; i++)
+  {
+    uint32_t item = order[i].item;
+    sortedMinX[i] = order[i].minX;
+    sortedMaxX[i] = maxX[item];
+    sortedMinY[i] = minY[item];
+    sortedMaxY[i] = maxY[item];
+    sortedItems[i] = item;
+    widest = std::max(widest, maxX[item] - minX[item]);
+  }
+}
+
+BoxSpan SweepAndPrune::spanAlongX(float minX, float maxX) const
+{
+  // Boxes starting before minX - widest end before minX; boxes starting after maxX are past it
+  size_t first = std::lower_bound(sortedMinX.begin(), sortedMinX.end(), minX - widest) - sortedMinX.begin();
+  size_t last = std::upper_bound(sortedMinX.begin() + first, sortedMinX.end(), maxX) - sortedMinX.begin();
+  return BoxSpan{ sortedMinX.data() + first, sortedMinY.data() + first, sortedMaxX.data() + first, sortedMaxY.data() + first,
+    sortedItems.data() + first, last - first };
+}
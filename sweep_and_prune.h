@@ -0,0 +1,65 @@
+#pragma once
+
+#include "box_kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sort-and-sweep broadphase along x. Boxes are kept sorted by their left edge; each box has a
+// key that stays the same from frame to frame (an entity slot index, say), so update starts
+// from the previous frame's order and insertion-sorts it, which is close to linear when boxes
+// move little between frames. Boxes new this frame are sorted on their own and merged in.
+// Queries binary-search the left edges and hand out the sorted run that can overlap on x as
+// one BoxSpan (the caller filters it, with BoxKernel), so dense clusters along x cost more
+// than clusters that are spread out along it.
+class SweepAndPrune
+{
+public:
+  // Boxes as SoA min/max arrays with their keys; items reported by queries are indices into
+  // these arrays
+  void update(const uint32_t* keys, const float* minX, const float* minY, const float* maxX, const float* maxY, size_t count);
+
+  // Calls fn(const BoxSpan& boxes) once with the boxes that may overlap [minX, maxX] on x;
+  // the span is a superset, so the caller still tests each box
+  template <typename Fn>
+  void queryBox(float minX, float /*minY*/, float maxX, float /*maxY*/, Fn&& fn) const
+  {
+    BoxSpan boxes = spanAlongX(minX, maxX);
+    if (boxes.count)
+      fn(boxes);
+  }
+
+  // Same callback as SpatialGrid::querySegment, with the span for the segment's bounds in one
+  // call (exit 1, so callers never stop early)
+  template <typename Fn>
+  void querySegment(float x0, float /*y0*/, float x1, float /*y1*/, Fn&& fn) const
+  {
+    BoxSpan boxes = spanAlongX(x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0);
+    if (boxes.count)
+      fn(boxes, 1.0f);
+  }
+
+  // Swaps done by the last update's insertion sort (how coherent the frame was)
+  size_t getLastSwapCount() const { return lastSwaps; }
+
+private:
+  struct Entry {
+    float minX;
+    uint32_t key;
+    uint32_t item;
+  };
+
+  std::vector<Entry> order;   // Sorted by minX as of the last update
+
+  // Sorted SoA copy for queries
+  std::vector<float> sortedMinX, sortedMaxX, sortedMinY, sortedMaxY;
+  std::vector<uint32_t> sortedItems;
+  float widest = 0.0f;   // Largest box width, bounds how far left of a query a box can start
+
+  std::vector<uint32_t> itemOfKey;   // Update scratch: key -> item, NONE if gone
+  std::vector<uint8_t> placed;       // Update scratch: item already in order
+  size_t lastSwaps = 0;
+
+  BoxSpan spanAlongX(float minX, float maxX) const;
+};
@@ -0,0 +1,658 @@
+#include "texture_codec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+namespace
+{
+  // 4x4 texels, row-major (texel i = y * 4 + x), RGBA
+  struct Block {
+    unsigned char px[16][4];
+  };
+
+  void loadBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, Block& block)
+  {
+    for (int y = 0; y < 4; y++)
+    {
+      for (int x = 0; x < 4; x++)
+      {
+        int sx = std::min(blockX * 4 + x, width - 1);
+        int sy = std::min(blockY * 4 + y, height - 1);
+        memcpy(block.px[y * 4 + x], rgba + ((size_t)sy * width + sx) * 4, 4);
+      }
+    }
+  }
+
+  int clamp255(int value)
+  {
+    return std::min(255, std::max(0, value));
+  }
+
+  int squaredDistance(const int* a, const unsigned char* b, int channels)
+  {
+    int sum = 0;
+    for (int c = 0; c < channels; c++)
+    {
+      int d = a[c] - b[c];
+      sum += d * d;
+    }
+    return sum;
+  }
+
+  // The two texels furthest apart; exact for blocks with one or two colors
+  void farthestPair(const Block& block, int channels, int& first, int& second)
+  {
+    first = 0;
+    second = 0;
+    int best = -1;
+    for (int i = 0; i < 16; i++)
+    {
+      for (int j = i + 1; j < 16; j++)
+      {
+        int d = 0;
+        for (int c = 0; c < channels; c++)
+        {
+          int diff = block.px[i][c] - block.px[j][c];
+          d += diff * diff;
+        }
+        if (d > best)
+        {
+          best = d;
+          first = i;
+          second = j;
+        }
+      }
+    }
+  }
+
+  // ---- BC3 (DXT5) ----------------------------------------------------------
+
+  uint16_t packRGB565(const unsigned char* color)
+  {
+    int r = (color[0] * 31 + 127) / 255;
+    int g = (color[1] * 63 + 127) / 255;
+    int b = (color[2] * 31 + 127) / 255;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+  }
+
+  void unpackRGB565(uint16_t value, int color[3])
+  {
+    int r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+  }
+
+  // Alpha palette for both BC3 alpha modes
+  void bc3AlphaPalette(int a0, int a1, int palette[8])
+  {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+      for (int i = 1; i <= 6; i++)
+        palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    }
+    else
+    {
+      for (int i = 1; i <= 4; i++)
+        palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+      palette[6] = 0;
+      palette[7] = 255;
+    }
+  }
+
+  int bc3AlphaIndices(const Block& block, int a0, int a1, int indices[16])
+  {
+    int palette[8];
+    bc3AlphaPalette(a0, a1, palette);
+    int error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      int best = INT_MAX;
+      for (int p = 0; p < 8; p++)
+      {
+        int d = std::abs(palette[p] - block.px[i][3]);
+        if (d < best)
+        {
+          best = d;
+          indices[i] = p;
+        }
+      }
+      error += best * best;
+    }
+    return error;
+  }
+
+  void encodeBC3Block(const Block& block, unsigned char out[16], int decoded[16][4])
+  {
+    // Alpha: try 8 interpolated values between min and max, and 6 values plus exact 0/255
+    int minAlpha = 255, maxAlpha = 0, minInner = 255, maxInner = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      int a = block.px[i][3];
+      minAlpha = std::min(minAlpha, a);
+      maxAlpha = std::max(maxAlpha, a);
+      if (a != 0 && a != 255)
+      {
+        minInner = std::min(minInner, a);
+        maxInner = std::max(maxInner, a);
+      }
+    }
+    if (minInner > maxInner)
+      minInner = maxInner = 0;
+
+    int alpha0 = maxAlpha, alpha1 = minAlpha, alphaIndices[16];
+    int alphaError = bc3AlphaIndices(block, alpha0, alpha1, alphaIndices);
+
+    int innerIndices[16];
+    int innerError = bc3AlphaIndices(block, minInner, maxInner, innerIndices);
+    if (innerError < alphaError)
+    {
+      alpha0 = minInner;
+      alpha1 = maxInner;
+      memcpy(alphaIndices, innerIndices, sizeof(alphaIndices));
+    }
+
+    int alphaPalette[8];
+    bc3AlphaPalette(alpha0, alpha1, alphaPalette);
+
+    out[0] = (unsigned char)alpha0;
+    out[1] = (unsigned char)alpha1;
+    uint64_t alphaBits = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      alphaBits |= (uint64_t)alphaIndices[i] << (3 * i);
+      decoded[i][3] = alphaPalette[alphaIndices[i]];
+    }
+    for (int i = 0; i < 6; i++)
+      out[2 + i] = (unsigned char)(alphaBits >> (8 * i));
+
+    // Color: endpoints from the farthest pair, always in four-color mode (color0 > color1)
+    int first, second;
+    farthestPair(block, 3, first, second);
+    uint16_t color0 = packRGB565(block.px[first]);
+    uint16_t color1 = packRGB565(block.px[second]);
+    if (color0 < color1)
+      std::swap(color0, color1);
+
+    int palette[4][3];
+    unpackRGB565(color0, palette[0]);
+    unpackRGB565(color1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    uint32_t colorBits = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      int index = 0;
+      if (color0 != color1)
+      {
+        int best = INT_MAX;
+        for (int p = 0; p < 4; p++)
+        {
+          int d = squaredDistance(palette[p], block.px[i], 3);
+          if (d < best)
+          {
+            best = d;
+            index = p;
+          }
+        }
+      }
+      colorBits |= (uint32_t)index << (2 * i);
+      for (int c = 0; c < 3; c++)
+        decoded[i][c] = palette[index][c];
+    }
+
+    out[8] = (unsigned char)(color0 & 0xFF);
+    out[9] = (unsigned char)(color0 >> 8);
+    out[10] = (unsigned char)(color1 & 0xFF);
+    out[11] = (unsigned char)(color1 >> 8);
+    for (int i = 0; i < 4; i++)
+      out[12 + i] = (unsigned char)(colorBits >> (8 * i));
+  }
+
+  // ---- BC7 (mode 6: one subset, RGBA 7.7.7.7 + p-bit endpoints, 4-bit indices) ----
+
+  const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  struct BitWriter {
+    unsigned char* bytes;
+    int position = 0;
+
+    void write(uint32_t value, int count)
+    {
+      for (int i = 0; i < count; i++, position++)
+      {
+        if (value & (1u << i))
+          bytes[position >> 3] |= (unsigned char)(1u << (position & 7));
+      }
+    }
+  };
+
+  int bc7Quantize(int value, int pBit)
+  {
+    // 7-bit value whose expansion (q << 1 | pBit) is nearest to value
+    int q = (value - pBit + 1) >> 1;
+    return std::min(127, std::max(0, q));
+  }
+
+  // Squared error of the block against the palette spanned by two quantized endpoints
+  int bc7Evaluate(const Block& block, const int q[2][4], const int p[2], int indices[16])
+  {
+    int palette[16][4];
+    for (int w = 0; w < 16; w++)
+    {
+      for (int c = 0; c < 4; c++)
+      {
+        int e0 = (q[0][c] << 1) | p[0];
+        int e1 = (q[1][c] << 1) | p[1];
+        palette[w][c] = ((64 - BC7_WEIGHTS[w]) * e0 + BC7_WEIGHTS[w] * e1 + 32) >> 6;
+      }
+    }
+
+    int error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      int best = INT_MAX;
+      for (int w = 0; w < 16; w++)
+      {
+        int d = squaredDistance(palette[w], block.px[i], 4);
+        if (d < best)
+        {
+          best = d;
+          indices[i] = w;
+        }
+      }
+      error += best;
+    }
+    return error;
+  }
+
+  // Least-squares endpoints for fixed indices; false if every texel uses the same weight
+  bool bc7Refit(const Block& block, const int indices[16], float endpoints[2][4])
+  {
+    float aa = 0, ab = 0, bb = 0, ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; i++)
+    {
+      float t = BC7_WEIGHTS[indices[i]] / 64.0f;
+      float a = 1.0f - t;
+      aa += a * a;
+      ab += a * t;
+      bb += t * t;
+      for (int c = 0; c < 4; c++)
+      {
+        ax[c] += a * block.px[i][c];
+        bx[c] += t * block.px[i][c];
+      }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (det < 1e-6f)
+      return false;
+    for (int c = 0; c < 4; c++)
+    {
+      endpoints[0][c] = std::min(255.0f, std::max(0.0f, (bb * ax[c] - ab * bx[c]) / det));
+      endpoints[1][c] = std::min(255.0f, std::max(0.0f, (aa * bx[c] - ab * ax[c]) / det));
+    }
+    return true;
+  }
+
+  void encodeBC7Block(const Block& block, unsigned char out[16], int decoded[16][4])
+  {
+    int first, second;
+    farthestPair(block, 4, first, second);
+
+    float endpoints[2][4];
+    for (int c = 0; c < 4; c++)
+    {
+      endpoints[0][c] = block.px[first][c];
+      endpoints[1][c] = block.px[second][c];
+    }
+
+    int bestError = INT_MAX;
+    int bestQ[2][4] = {}, bestP[2] = {}, bestIndices[16] = {};
+
+    // Start from the farthest pair, then refine the endpoints against the chosen indices.
+    // Every candidate tries all four p-bit combinations.
+    for (int pass = 0; pass < 3; pass++)
+    {
+      if (pass > 0 && !bc7Refit(block, bestIndices, endpoints))
+        break;
+
+      for (int pBits = 0; pBits < 4; pBits++)
+      {
+        int p[2] = { pBits & 1, pBits >> 1 };
+        int q[2][4], indices[16];
+        for (int c = 0; c < 4; c++)
+        {
+          q[0][c] = bc7Quantize((int)(endpoints[0][c] + 0.5f), p[0]);
+          q[1][c] = bc7Quantize((int)(endpoints[1][c] + 0.5f), p[1]);
+        }
+
+        int error = bc7Evaluate(block, q, p, indices);
+        if (error < bestError)
+        {
+          bestError = error;
+          memcpy(bestQ, q, sizeof(q));
+          bestP[0] = p[0];
+          bestP[1] = p[1];
+          memcpy(bestIndices, indices, sizeof(indices));
+        }
+      }
+    }
+
+    // The anchor (texel 0) index is stored without its top bit, so it must be < 8
+    if (bestIndices[0] >= 8)
+    {
+      for (int c = 0; c < 4; c++)
+        std::swap(bestQ[0][c], bestQ[1][c]);
+      std::swap(bestP[0], bestP[1]);
+      for (int i = 0; i < 16; i++)
+        bestIndices[i] = 15 - bestIndices[i];
+    }
+
+    memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1u << 6, 7);   // Mode 6
+    for (int c = 0; c < 4; c++)
+    {
+      writer.write((uint32_t)bestQ[0][c], 7);
+      writer.write((uint32_t)bestQ[1][c], 7);
+    }
+    writer.write((uint32_t)bestP[0], 1);
+    writer.write((uint32_t)bestP[1], 1);
+    for (int i = 0; i < 16; i++)
+      writer.write((uint32_t)bestIndices[i], i == 0 ? 3 : 4);
+
+    for (int i = 0; i < 16; i++)
+    {
+      int w = BC7_WEIGHTS[bestIndices[i]];
+      for (int c = 0; c < 4; c++)
+      {
+        int e0 = (bestQ[0][c] << 1) | bestP[0];
+        int e1 = (bestQ[1][c] << 1) | bestP[1];
+        decoded[i][c] = ((64 - w) * e0 + w * e1 + 32) >> 6;
+      }
+    }
+  }
+
+  // ---- ETC2 RGBA8 (EAC alpha + ETC1-compatible color modes) ----------------
+
+  const int EAC_MODIFIERS[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+  };
+
+  const int ETC1_MODIFIERS[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+  };
+
+  // ETC texel i is column-major (i = x * 4 + y)
+  const unsigned char* etcTexel(const Block& block, int i)
+  {
+    return block.px[(i % 4) * 4 + i / 4];
+  }
+
+  void writeBigEndian(uint64_t value, unsigned char* out, int byteCount)
+  {
+    for (int i = 0; i < byteCount; i++)
+      out[i] = (unsigned char)(value >> (8 * (byteCount - 1 - i)));
+  }
+
+  void encodeEACAlpha(const Block& block, unsigned char out[8], int decoded[16][4])
+  {
+    int minAlpha = 255, maxAlpha = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      minAlpha = std::min(minAlpha, (int)block.px[i][3]);
+      maxAlpha = std::max(maxAlpha, (int)block.px[i][3]);
+    }
+
+    int bestError = INT_MAX, bestBase = 0, bestTable = 0, bestMultiplier = 1, bestIndices[16] = {};
+    for (int table = 0; table < 16 && bestError > 0; table++)
+    {
+      const int* modifiers = EAC_MODIFIERS[table];
+      for (int multiplier = 1; multiplier < 16 && bestError > 0; multiplier++)
+      {
+        // Center the table's range on the block's range, then search nearby bases
+        int center = (int)((minAlpha + maxAlpha) / 2.0f - (modifiers[3] + modifiers[7]) * multiplier / 2.0f + 0.5f);
+        for (int base = center - 1; base <= center + 1; base++)
+        {
+          if (base < 0 || base > 255)
+            continue;
+
+          int error = 0, indices[16];
+          for (int i = 0; i < 16 && error < bestError; i++)
+          {
+            int alpha = etcTexel(block, i)[3];
+            int best = INT_MAX;
+            for (int m = 0; m < 8; m++)
+            {
+              int d = std::abs(clamp255(base + modifiers[m] * multiplier) - alpha);
+              if (d < best)
+              {
+                best = d;
+                indices[i] = m;
+              }
+            }
+            error += best * best;
+          }
+
+          if (error < bestError)
+          {
+            bestError = error;
+            bestBase = base;
+            bestTable = table;
+            bestMultiplier = multiplier;
+            memcpy(bestIndices, indices, sizeof(indices));
+          }
+        }
+      }
+    }
+
+    out[0] = (unsigned char)bestBase;
+    out[1] = (unsigned char)((bestMultiplier << 4) | bestTable);
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++)
+    {
+      bits |= (uint64_t)bestIndices[i] << (45 - 3 * i);
+      int y = i % 4, x = i / 4;
+      decoded[y * 4 + x][3] = clamp255(bestBase + EAC_MODIFIERS[bestTable][bestIndices[i]] * bestMultiplier);
+    }
+    writeBigEndian(bits, out + 2, 6);
+  }
+
+  // Best ETC1 table and per-texel indices for one sub-block with a fixed base color
+  int etcSubBlock(const Block& block, const bool inSubBlock[16], const int base[3], int& tableOut, int indices[16])
+  {
+    int bestError = INT_MAX;
+    for (int table = 0; table < 8; table++)
+    {
+      int modifiers[4] = { ETC1_MODIFIERS[table][0], ETC1_MODIFIERS[table][1],
+        -ETC1_MODIFIERS[table][0], -ETC1_MODIFIERS[table][1] };
+      int error = 0, tableIndices[16] = {};
+      for (int i = 0; i < 16; i++)
+      {
+        if (!inSubBlock[i])
+          continue;
+
+        const unsigned char* texel = etcTexel(block, i);
+        int best = INT_MAX;
+        for (int m = 0; m < 4; m++)
+        {
+          int color[3] = { clamp255(base[0] + modifiers[m]), clamp255(base[1] + modifiers[m]),
+            clamp255(base[2] + modifiers[m]) };
+          int d = squaredDistance(color, texel, 3);
+          if (d < best)
+          {
+            best = d;
+            tableIndices[i] = m;
+          }
+        }
+        error += best;
+      }
+
+      if (error < bestError)
+      {
+        bestError = error;
+        tableOut = table;
+        for (int i = 0; i < 16; i++)
+          if (inSubBlock[i])
+            indices[i] = tableIndices[i];
+      }
+    }
+    return bestError;
+  }
+
+  void encodeETC2Color(const Block& block, unsigned char out[8], int decoded[16][4])
+  {
+    uint64_t bestWord = 0;
+    int bestError = INT_MAX;
+
+    for (int flip = 0; flip < 2; flip++)
+    {
+      // flip 0: left/right 2x4 halves, flip 1: top/bottom 4x2 halves
+      bool inSub[2][16];
+      float average[2][3] = {};
+      for (int i = 0; i < 16; i++)
+      {
+        int y = i % 4, x = i / 4;
+        int sub = flip ? (y >= 2) : (x >= 2);
+        inSub[sub][i] = true;
+        inSub[1 - sub][i] = false;
+        for (int c = 0; c < 3; c++)
+          average[sub][c] += etcTexel(block, i)[c] / 8.0f;
+      }
+
+      for (int differential = 1; differential >= 0; differential--)
+      {
+        int quantized[2][3], base[2][3];
+        int levels = differential ? 31 : 15;
+        for (int s = 0; s < 2; s++)
+        {
+          for (int c = 0; c < 3; c++)
+          {
+            quantized[s][c] = (int)(average[s][c] * levels / 255.0f + 0.5f);
+            base[s][c] = differential ? ((quantized[s][c] << 3) | (quantized[s][c] >> 2))
+              : ((quantized[s][c] << 4) | quantized[s][c]);
+          }
+        }
+
+        // Deltas outside [-4, 3] would select ETC2's T/H/planar modes instead
+        int delta[3];
+        bool representable = true;
+        for (int c = 0; c < 3; c++)
+        {
+          delta[c] = quantized[1][c] - quantized[0][c];
+          if (delta[c] < -4 || delta[c] > 3)
+            representable = false;
+        }
+        if (differential && !representable)
+          continue;
+
+        int tables[2] = {}, indices[16] = {};
+        int error = etcSubBlock(block, inSub[0], base[0], tables[0], indices) +
+          etcSubBlock(block, inSub[1], base[1], tables[1], indices);
+        if (error >= bestError)
+          continue;
+
+        uint32_t high;
+        if (differential)
+        {
+          high = (uint32_t)(quantized[0][0] << 27) | (uint32_t)((delta[0] & 7) << 24) |
+            (uint32_t)(quantized[0][1] << 19) | (uint32_t)((delta[1] & 7) << 16) |
+            (uint32_t)(quantized[0][2] << 11) | (uint32_t)((delta[2] & 7) << 8);
+        }
+        else
+        {
+          high = (uint32_t)(quantized[0][0] << 28) | (uint32_t)(quantized[1][0] << 24) |
+            (uint32_t)(quantized[0][1] << 20) | (uint32_t)(quantized[1][1] << 16) |
+            (uint32_t)(quantized[0][2] << 12) | (uint32_t)(quantized[1][2] << 8);
+        }
+        high |= (uint32_t)(tables[0] << 5) | (uint32_t)(tables[1] << 2) | (uint32_t)(differential << 1) | (uint32_t)flip;
+
+        uint32_t low = 0;
+        for (int i = 0; i < 16; i++)
+        {
+          low |= (uint32_t)(indices[i] & 1) << i;
+          low |= (uint32_t)(indices[i] >> 1) << (16 + i);
+
+          int sub = inSub[1][i] ? 1 : 0;
+          int m = ETC1_MODIFIERS[tables[sub]][indices[i] & 1] * ((indices[i] & 2) ? -1 : 1);
+          int y = i % 4, x = i / 4;
+          for (int c = 0; c < 3; c++)
+            decoded[y * 4 + x][c] = clamp255(base[sub][c] + m);
+        }
+
+        bestError = error;
+        bestWord = ((uint64_t)high << 32) | low;
+      }
+    }
+
+    // decoded[] holds the winner because later candidates only write when they improve
+    writeBigEndian(bestWord, out, 8);
+  }
+
+  void encodeETC2Block(const Block& block, unsigned char out[16], int decoded[16][4])
+  {
+    encodeEACAlpha(block, out, decoded);
+    encodeETC2Color(block, out + 8, decoded);
+  }
+}
+
+size_t TextureCodec::encodedSize(int width, int height)
+{
+  return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 16;
+}
+
+bool TextureCodec::encode(BakedTextureFormat format, const unsigned char* rgba, int width, int height,
+  std::vector<unsigned char>& out, int& maxError)
+{
+  void (*encodeBlock)(const Block&, unsigned char*, int[16][4]) = nullptr;
+  if (format == BAKED_FORMAT_BC3)
+    encodeBlock = encodeBC3Block;
+  else if (format == BAKED_FORMAT_BC7)
+    encodeBlock = encodeBC7Block;
+  else if (format == BAKED_FORMAT_ETC2)
+    encodeBlock = encodeETC2Block;
+  else
+    return false;
+
+  int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+  out.assign(encodedSize(width, height), 0);
+  maxError = 0;
+
+  for (int by = 0; by < blocksY; by++)
+  {
+    for (int bx = 0; bx < blocksX; bx++)
+    {
+      Block block;
+      loadBlock(rgba, width, height, bx, by, block);
+
+      int decoded[16][4];
+      encodeBlock(block, out.data() + ((size_t)by * blocksX + bx) * 16, decoded);
+
+      // Only texels inside the image count towards the error
+      for (int i = 0; i < 16; i++)
+      {
+        if (bx * 4 + i % 4 >= width || by * 4 + i / 4 >= height)
+          continue;
+        for (int c = 0; c < 4; c++)
+          maxError = std::max(maxError, std::abs(decoded[i][c] - block.px[i][c]));
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "baked_texture.h"
+#include <vector>
+
+// CPU block-compression encoders used by the offline asset tool.
+// Every supported format stores 16 bytes per 4x4 block (1 byte per texel, 4x smaller than RGBA8).
+// Input is tightly packed RGBA8 in OpenGL row order; partial edge blocks repeat the last texel.
+class TextureCodec
+{
+public:
+  // Encode one mip level. maxError receives the largest per-channel difference between the
+  // source and the decoded result, which pixel-art mode uses to reject lossy variants.
+  // Returns false for formats that are not block-compressed.
+  static bool encode(BakedTextureFormat format, const unsigned char* rgba, int width, int height,
+    std::vector<unsigned char>& out, int& maxError);
+
+  // Compressed size of one level in bytes
+  static size_t encodedSize(int width, int height);
+};
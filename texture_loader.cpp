@@ -1,12 +1,98 @@
 #include "texture_loader.h"
+#include "baked_texture.h"
+#include "asset_pack.h"
 #include <glad/glad.h>
 #include <iostream>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-unsigned int TextureLoader::loadTexture(const char* path)
+namespace
 {
+  struct RegistryEntry {
+    int refCount = 0;
+    uint64_t contentHash = 0;
+    bool premultiplied = false;
+    std::vector<std::string> keys;   // Every path/name that resolves to this texture
+  };
+
+  std::unordered_map<unsigned int, RegistryEntry> registry;   // By texture ID
+  std::unordered_map<std::string, unsigned int> textureByKey;
+  std::unordered_map<uint64_t, unsigned int> textureByHash;
+
+  GLenum formatForChannels(int channels)
+  {
+    if (channels == 1)
+      return GL_RED;
+    if (channels == 3)
+      return GL_RGB;
+    return GL_RGBA;
+  }
+
+  // Base level only; TextureSampler::prepareTexture builds mipmaps if a profile needs them.
+  // The parameters keep the texture complete when no sampler object is bound.
+  void setDefaultParameters()
+  {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  }
+
+  // Pack names are relative to the asset root
+  std::string packNameFor(const std::string& path)
+  {
+    const std::string root = "assets/";
+    return path.compare(0, root.size(), root) == 0 ? path.substr(root.size()) : path;
+  }
+
+  // Upload a pack entry found by findPackedTexture; 0 if it does not decode
+  unsigned int uploadPackedTexture(const AssetView& view, bool baked, bool* premultiplied)
+  {
+    if (baked)
+    {
+      unsigned int textureID = BakedTexture::upload(view.data, view.size);
+      if (textureID != 0 && premultiplied)
+        *premultiplied = BakedTexture::isPremultiplied(view.data, view.size);
+      return textureID;
+    }
+
+    ImageData image;
+    if (!TextureLoader::decodeImage(view.data, view.size, image))
+      return 0;
+    return TextureLoader::uploadTexture(image);
+  }
+}
+
+unsigned int TextureLoader::loadTexture(const char* path, bool* premultiplied)
+{
+  if (premultiplied)
+    *premultiplied = false;
+
+  bool baked;
+  AssetView packed = findPackedTexture(path, baked);
+  if (packed.isValid())
+  {
+    unsigned int packedID = uploadPackedTexture(packed, baked, premultiplied);
+    if (packedID != 0)
+      return packedID;
+  }
+
+  // Prefer a baked .ltex next to the source image: no inflate, no mip generation.
+  // Compressed variants come first when the driver can sample them.
+  for (const auto& bakedPath : BakedTexture::candidatePathsFor(path))
+  {
+    unsigned int bakedID = BakedTexture::loadFile(bakedPath.c_str(), premultiplied);
+    if (bakedID != 0)
+      return bakedID;
+  }
+
   unsigned int textureID;
   glGenTextures(1, &textureID);
 
@@ -16,22 +102,11 @@ unsigned int TextureLoader::loadTexture(const char* path)
 
   if (data)
   {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
+    GLenum format = formatForChannels(nrChannels);
 
     glBindTexture(GL_TEXTURE_2D, textureID);
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    setDefaultParameters();
 
     stbi_image_free(data);
   }
@@ -39,8 +114,255 @@ unsigned int TextureLoader::loadTexture(const char* path)
   {
     std::cout << "Failed to load texture: " << path << std::endl;
     stbi_image_free(data);
+    glDeleteTextures(1, &textureID);
     return 0;
   }
 
   return textureID;
-}
\ No newline at end of file
+}
+
+bool TextureLoader::decodeImage(const unsigned char* bytes, size_t size, ImageData& image)
+{
+  // The thread-local flip flag keeps concurrent decodes independent
+  stbi_set_flip_vertically_on_load_thread(true);
+
+  int width, height, nrChannels;
+  unsigned char* data = stbi_load_from_memory(bytes, (int)size, &width, &height, &nrChannels, 0);
+  if (!data)
+    return false;
+
+  image.width = width;
+  image.height = height;
+  image.channels = nrChannels;
+  image.pixels.assign(data, data + (size_t)width * height * nrChannels);
+  stbi_image_free(data);
+  return true;
+}
+
+unsigned int TextureLoader::uploadTexture(const ImageData& image, bool usePixelBuffer)
+{
+  if (!image.isValid())
+    return 0;
+
+  unsigned int textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+
+  GLenum format = formatForChannels(image.channels);
+  size_t byteCount = image.pixels.size();
+
+  // Rows of 1- and 3-channel images are not 4-byte aligned in general
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if (usePixelBuffer)
+  {
+    // Copy into driver-owned memory; glTexImage2D then sources from the buffer
+    // and the driver is free to schedule the transfer asynchronously
+    unsigned int pbo;
+    glGenBuffers(1, &pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, byteCount, nullptr, GL_STREAM_DRAW);
+
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, byteCount,
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped)
+    {
+      memcpy(mapped, image.pixels.data(), byteCount);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, (void*)0);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &pbo);
+
+    if (!mapped)
+    {
+      // Mapping failed: fall back to a client-memory upload
+      glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+    }
+  }
+  else
+  {
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  setDefaultParameters();
+
+  return textureID;
+}
+
+unsigned int TextureLoader::acquireTexture(const std::string& path)
+{
+  unsigned int cached = acquireCachedTexture(path);
+  if (cached != 0)
+    return cached;
+
+  // Pack entries carry their content hash, so a shared texture needs no upload
+  bool baked;
+  AssetView packed = findPackedTexture(path, baked);
+  if (packed.isValid())
+  {
+    auto byHash = textureByHash.find(packed.contentHash);
+    if (byHash != textureByHash.end())
+      return registerTexture(path, byHash->second, packed.contentHash);
+
+    bool premultiplied = false;
+    unsigned int packedID = uploadPackedTexture(packed, baked, &premultiplied);
+    if (packedID != 0)
+      return registerTexture(path, packedID, packed.contentHash, premultiplied);
+  }
+
+  // First use of a loose file: hash the source so an identical image under another path is shared
+  std::vector<unsigned char> bytes;
+  std::ifstream file(path, std::ios::binary);
+  if (file)
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  uint64_t contentHash = bytes.empty() ? 0 : AssetPack::hash(bytes.data(), bytes.size());
+
+  auto byHash = textureByHash.find(contentHash);
+  if (contentHash != 0 && byHash != textureByHash.end())
+    return registerTexture(path, byHash->second, contentHash);
+
+  bool premultiplied;
+  unsigned int textureID = loadTexture(path.c_str(), &premultiplied);
+  if (textureID == 0)
+    return 0;
+  return registerTexture(path, textureID, contentHash, premultiplied);
+}
+
+AssetView TextureLoader::findPackedTexture(const std::string& path, bool& baked)
+{
+  baked = false;
+  const AssetPack* pack = AssetPack::getMounted();
+  if (!pack)
+    return AssetView();
+
+  std::string name = packNameFor(path);
+  for (const auto& bakedName : BakedTexture::candidatePathsFor(name))
+  {
+    AssetView view = pack->find(bakedName);
+    if (view.isValid() && BakedTexture::validate(view.data, view.size))
+    {
+      baked = true;
+      return view;
+    }
+  }
+  return pack->find(name);
+}
+
+unsigned int TextureLoader::acquireCachedTexture(const std::string& key)
+{
+  auto it = textureByKey.find(key);
+  if (it == textureByKey.end())
+    return 0;
+
+  registry[it->second].refCount++;
+  return it->second;
+}
+
+unsigned int TextureLoader::registerTexture(const std::string& key, unsigned int textureID, uint64_t contentHash,
+  bool premultiplied)
+{
+  if (textureID == 0)
+    return 0;
+
+  // Same key, or same pixels under another name: share the resident copy
+  unsigned int existing = 0;
+  auto byKey = textureByKey.find(key);
+  if (byKey != textureByKey.end())
+    existing = byKey->second;
+  else if (contentHash != 0)
+  {
+    auto byHash = textureByHash.find(contentHash);
+    if (byHash != textureByHash.end())
+      existing = byHash->second;
+  }
+
+  if (existing != 0 && existing != textureID)
+  {
+    glDeleteTextures(1, &textureID);
+
+    RegistryEntry& entry = registry[existing];
+    if (byKey == textureByKey.end())
+    {
+      entry.keys.push_back(key);
+      textureByKey[key] = existing;
+    }
+    entry.refCount++;
+    return existing;
+  }
+
+  // A texture registered again under another key keeps the flag it was uploaded with
+  bool uploaded = registry.find(textureID) == registry.end();
+  RegistryEntry& entry = registry[textureID];
+  entry.refCount++;
+  if (uploaded)
+    entry.premultiplied = premultiplied;
+  if (byKey == textureByKey.end())
+  {
+    entry.keys.push_back(key);
+    textureByKey[key] = textureID;
+  }
+  if (contentHash != 0 && entry.contentHash == 0)
+  {
+    entry.contentHash = contentHash;
+    textureByHash[contentHash] = textureID;
+  }
+  return textureID;
+}
+
+void TextureLoader::releaseTexture(unsigned int textureID)
+{
+  auto it = registry.find(textureID);
+  if (it == registry.end())
+  {
+    // Not shared through the registry: the caller was the only owner
+    if (textureID != 0)
+      glDeleteTextures(1, &textureID);
+    return;
+  }
+
+  if (it->second.refCount > 0)
+    it->second.refCount--;
+}
+
+size_t TextureLoader::evictUnusedTextures()
+{
+  size_t evicted = 0;
+  for (auto it = registry.begin(); it != registry.end();)
+  {
+    if (it->second.refCount > 0)
+    {
+      ++it;
+      continue;
+    }
+
+    for (const auto& key : it->second.keys)
+      textureByKey.erase(key);
+    if (it->second.contentHash != 0)
+      textureByHash.erase(it->second.contentHash);
+
+    unsigned int textureID = it->first;
+    glDeleteTextures(1, &textureID);
+    it = registry.erase(it);
+    evicted++;
+  }
+  return evicted;
+}
+
+size_t TextureLoader::getRegisteredTextureCount()
+{
+  return registry.size();
+}
+
+bool TextureLoader::isPremultiplied(unsigned int textureID)
+{
+  auto it = registry.find(textureID);
+  return it != registry.end() && it->second.premultiplied;
+}
+
+void TextureLoader::applyBlendFunc(unsigned int textureID)
+{
+  glBlendFunc(isPremultiplied(textureID) ? GL_ONE : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
@@ -1,9 +1,70 @@
 #pragma once
 
-// Utility class for loading textures
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AssetView;
+
+// Decoded pixels ready for upload (rows already flipped for OpenGL)
+struct ImageData {
+  std::string path;                  // File the pixels came from
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  std::vector<unsigned char> pixels;
+
+  bool isValid() const { return !pixels.empty(); }
+};
+
+// Utility class for loading textures.
+// Also keeps a reference-counted registry so each image is uploaded once no matter
+// how many systems use it. Registry functions are GL-thread only.
+// Paths resolve against the mounted AssetPack first (a baked entry, then the source image,
+// named relative to the asset root: assets/llama.png is llama.png), then loose files.
 class TextureLoader
 {
 public:
-  // Load a texture from file path
-  static unsigned int loadTexture(const char* path);
-};
\ No newline at end of file
+  // Load a texture from file path (uncached; the caller owns the texture). premultiplied
+  // (optional) receives whether its color is premultiplied by alpha.
+  static unsigned int loadTexture(const char* path, bool* premultiplied = nullptr);
+
+  // Get a shared texture by path, loading it on first use. Adds a reference.
+  static unsigned int acquireTexture(const std::string& path);
+
+  // Mounted pack entry for a texture path: the best supported baked variant, else the source
+  // image; invalid if there is no pack or it has neither. Safe to call from any thread.
+  static AssetView findPackedTexture(const std::string& path, bool& baked);
+
+  // Add a reference to a texture already in the registry; returns 0 if key is unknown
+  static unsigned int acquireCachedTexture(const std::string& key);
+
+  // Hand an uploaded texture to the registry under key (with one reference), noting whether
+  // its color is premultiplied by alpha. If the key or the non-zero content hash is already
+  // registered, the new texture is deleted and the existing one is returned instead.
+  static unsigned int registerTexture(const std::string& key, unsigned int textureID, uint64_t contentHash = 0,
+    bool premultiplied = false);
+
+  // Drop a reference. Unreferenced textures stay resident until evicted.
+  static void releaseTexture(unsigned int textureID);
+
+  // Delete every texture nobody references; returns how many were freed
+  static size_t evictUnusedTextures();
+
+  // Number of textures currently held by the registry
+  static size_t getRegisteredTextureCount();
+
+  // Whether a registered texture holds premultiplied color (baked with --premultiply)
+  static bool isPremultiplied(unsigned int textureID);
+
+  // Blend function for drawing a texture: GL_ONE, GL_ONE_MINUS_SRC_ALPHA for premultiplied
+  // color, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA otherwise (GL thread only)
+  static void applyBlendFunc(unsigned int textureID);
+
+  // Decode an encoded image (PNG, etc.) held in memory. Safe to call from any thread.
+  static bool decodeImage(const unsigned char* bytes, size_t size, ImageData& image);
+
+  // Create a texture from decoded pixels (GL thread only).
+  // With usePixelBuffer the pixels are staged through a pixel buffer object.
+  static unsigned int uploadTexture(const ImageData& image, bool usePixelBuffer = false);
+};
@@ -0,0 +1,83 @@
+#include "texture_sampler.h"
+#include <glad/glad.h>
+
+namespace
+{
+  unsigned int samplers[(int)SamplerProfile::Count] = {};
+}
+
+bool TextureSampler::initialize()
+{
+  if (samplers[0] != 0)
+    return true;
+
+  glGenSamplers((int)SamplerProfile::Count, samplers);
+
+  // Nearest keeps texel edges crisp and clamping stops REPEAT from wrapping in the
+  // opposite edge of the sheet
+  unsigned int pixelArt = samplers[(int)SamplerProfile::PixelArt];
+  glSamplerParameteri(pixelArt, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glSamplerParameteri(pixelArt, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glSamplerParameteri(pixelArt, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glSamplerParameteri(pixelArt, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  unsigned int mipmapped = samplers[(int)SamplerProfile::LinearMipmapped];
+  glSamplerParameteri(mipmapped, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glSamplerParameteri(mipmapped, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glSamplerParameteri(mipmapped, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glSamplerParameteri(mipmapped, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+  return glGetError() == GL_NO_ERROR;
+}
+
+void TextureSampler::shutdown()
+{
+  if (samplers[0] == 0)
+    return;
+
+  glDeleteSamplers((int)SamplerProfile::Count, samplers);
+  for (auto& sampler : samplers)
+    sampler = 0;
+}
+
+unsigned int TextureSampler::get(SamplerProfile profile)
+{
+  return samplers[(int)profile];
+}
+
+void TextureSampler::bind(SamplerProfile profile, unsigned int unit)
+{
+  glBindSampler(unit, samplers[(int)profile]);
+}
+
+void TextureSampler::prepareTexture(unsigned int textureID, SamplerProfile profile)
+{
+  if (textureID == 0 || !usesMipmaps(profile))
+    return;
+
+  // Single-level uploads clamp MAX_LEVEL to 0; baked textures already carry their chain
+  GLint maxLevel = 0;
+  glBindTexture(GL_TEXTURE_2D, textureID);
+  glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+  if (maxLevel != 0)
+    return;
+
+  GLint width = 0, height = 0;
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+  if (width <= 1 && height <= 1)
+    return;
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+  glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+const char* TextureSampler::profileName(SamplerProfile profile)
+{
+  switch (profile)
+  {
+  case SamplerProfile::PixelArt: return "pixel-art";
+  case SamplerProfile::LinearMipmapped: return "linear-mipmapped";
+  default: return "unknown";
+  }
+}
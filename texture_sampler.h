@@ -0,0 +1,34 @@
+#pragma once
+
+// Filtering and addressing presets. Each texture owner picks one; the state lives in
+// sampler objects, so switching profiles never touches the texture itself.
+enum class SamplerProfile {
+  PixelArt,          // Nearest, clamp to edge, base level only (sprite sheets)
+  LinearMipmapped,   // Trilinear, repeat (art drawn scaled down)
+  Count
+};
+
+// Owns one sampler object per profile (GL thread only)
+class TextureSampler
+{
+public:
+  // Create the sampler objects; call once after OpenGL is loaded
+  static bool initialize();
+
+  // Delete the sampler objects
+  static void shutdown();
+
+  // Sampler object for a profile, 0 before initialize
+  static unsigned int get(SamplerProfile profile);
+
+  // Bind a profile's sampler to a texture unit; overrides the bound texture's own parameters
+  static void bind(SamplerProfile profile, unsigned int unit = 0);
+
+  // Make a texture complete for a profile. Mipmaps are only built here, the first time
+  // a texture that has none is used with a mipmapped profile.
+  static void prepareTexture(unsigned int textureID, SamplerProfile profile);
+
+  static bool usesMipmaps(SamplerProfile profile) { return profile == SamplerProfile::LinearMipmapped; }
+
+  static const char* profileName(SamplerProfile profile);
+};
@@ -0,0 +1,80 @@
+#include "transform_math.h"
+#include "sprite_sheet.h"
+
+#include <algorithm>
+
+void transformPoints(const Affine2D& transform, const float* xy, float* out, size_t count)
+{
+  size_t i = 0;
+#if LLAMA_MATH_SSE
+  // Two points per register: (x0, y0, x1, y1)
+  __m128 ab = _mm_setr_ps(transform.a, transform.b, transform.a, transform.b);
+  __m128 cd = _mm_setr_ps(transform.c, transform.d, transform.c, transform.d);
+  __m128 t = _mm_setr_ps(transform.tx, transform.ty, transform.tx, transform.ty);
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128 points = _mm_loadu_ps(xy + i * 2);
+    __m128 xs = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 ys = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, ab), _mm_mul_ps(ys, cd)), t);
+    _mm_storeu_ps(out + i * 2, result);
+  }
+#endif
+  for (; i < count; i++)
+  {
+    float x = xy[i * 2], y = xy[i * 2 + 1];
+    transform.transformPoint(x, y, out[i * 2], out[i * 2 + 1]);
+  }
+}
+
+void buildTranslationInstances(const Mat4& base, const float* xy, Mat4* out, size_t count)
+{
+#if LLAMA_MATH_SSE
+  // Only the last column changes: base.col3 + x * base.col0 + y * base.col1
+  __m128 c0 = _mm_load_ps(base.m), c1 = _mm_load_ps(base.m + 4);
+  __m128 c2 = _mm_load_ps(base.m + 8), c3 = _mm_load_ps(base.m + 12);
+  for (size_t i = 0; i < count; i++)
+  {
+    __m128 translated = _mm_add_ps(c3, _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(xy[i * 2])),
+      _mm_mul_ps(c1, _mm_set1_ps(xy[i * 2 + 1]))));
+    _mm_store_ps(out[i].m, c0);
+    _mm_store_ps(out[i].m + 4, c1);
+    _mm_store_ps(out[i].m + 8, c2);
+    _mm_store_ps(out[i].m + 12, translated);
+  }
+#else
+  for (size_t i = 0; i < count; i++)
+    out[i] = base * Mat4::translation(xy[i * 2], xy[i * 2 + 1]);
+#endif
+}
+
+void buildSpriteInstances(const Mat4& base, const float* xy, const float* sizes, const int* frames,
+  const FrameUV* frameTable, SpriteInstance* out, size_t count)
+{
+#if LLAMA_MATH_SSE
+  // The scale only touches the first two columns: size * base.col0, size * base.col1,
+  // base.col2, base.col3 + x * base.col0 + y * base.col1
+  __m128 c0 = _mm_load_ps(base.m), c1 = _mm_load_ps(base.m + 4);
+  __m128 c2 = _mm_load_ps(base.m + 8), c3 = _mm_load_ps(base.m + 12);
+  for (size_t i = 0; i < count; i++)
+  {
+    __m128 size = _mm_set1_ps(sizes[i]);
+    __m128 translated = _mm_add_ps(c3, _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(xy[i * 2])),
+      _mm_mul_ps(c1, _mm_set1_ps(xy[i * 2 + 1]))));
+    _mm_store_ps(out[i].transform.m, _mm_mul_ps(c0, size));
+    _mm_store_ps(out[i].transform.m + 4, _mm_mul_ps(c1, size));
+    _mm_store_ps(out[i].transform.m + 8, c2);
+    _mm_store_ps(out[i].transform.m + 12, translated);
+
+    const float* uv = frameTable[frames[i]].coords;
+    _mm_store_ps(out[i].uv, _mm_loadu_ps(uv));
+    _mm_store_ps(out[i].uv + 4, _mm_loadu_ps(uv + 4));
+  }
+#else
+  for (size_t i = 0; i < count; i++)
+  {
+    out[i].transform = base * Mat4::translation(xy[i * 2], xy[i * 2 + 1]) * Mat4::scale(sizes[i], sizes[i]);
+    std::copy(frameTable[frames[i]].coords, frameTable[frames[i]].coords + 8, out[i].uv);
+  }
+#endif
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "fast_math.h"
+
+#include <cmath>
+#include <cstddef>
+
+// SSE is used when the target has it (always on x86-64); define LLAMA_MATH_SSE=0 to force scalar code
+#ifndef LLAMA_MATH_SSE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLAMA_MATH_SSE 1
+#else
+#define LLAMA_MATH_SSE 0
+#endif
+#endif
+
+#if LLAMA_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+struct Affine2D;
+struct FrameUV;
+
+// 4x4 matrix, column-major like OpenGL (m[12], m[13], m[14] hold the translation)
+struct alignas(16) Mat4 {
+  float m[16];
+
+  constexpr Mat4() : m{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 } {}
+
+  static constexpr Mat4 identity() { return Mat4(); }
+
+  static constexpr Mat4 scale(float x, float y, float z = 1.0f)
+  {
+    Mat4 result;
+    result.m[0] = x;
+    result.m[5] = y;
+    result.m[10] = z;
+    return result;
+  }
+
+  static constexpr Mat4 translation(float x, float y, float z = 0.0f)
+  {
+    Mat4 result;
+    result.m[12] = x;
+    result.m[13] = y;
+    result.m[14] = z;
+    return result;
+  }
+
+  static Mat4 rotationZ(float angle);
+
+  const float* data() const { return m; }
+
+  Mat4 operator*(const Mat4& rhs) const
+  {
+    Mat4 result;
+#if LLAMA_MATH_SSE
+    // Each result column is a weighted sum of this matrix's columns
+    __m128 c0 = _mm_load_ps(m), c1 = _mm_load_ps(m + 4), c2 = _mm_load_ps(m + 8), c3 = _mm_load_ps(m + 12);
+    for (int col = 0; col < 4; col++)
+    {
+      const float* r = rhs.m + col * 4;
+      __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(r[0]));
+      sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(r[1])));
+      sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(r[2])));
+      sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(r[3])));
+      _mm_store_ps(result.m + col * 4, sum);
+    }
+#else
+    for (int col = 0; col < 4; col++)
+    {
+      for (int row = 0; row < 4; row++)
+      {
+        float sum = 0.0f;
+        for (int k = 0; k < 4; k++)
+          sum += m[k * 4 + row] * rhs.m[col * 4 + k];
+        result.m[col * 4 + row] = sum;
+      }
+    }
+#endif
+    return result;
+  }
+};
+
+// 2D affine transform: x' = a*x + c*y + tx, y' = b*x + d*y + ty
+struct Affine2D {
+  float a, b, c, d, tx, ty;
+
+  constexpr Affine2D() : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+  constexpr Affine2D(float a, float b, float c, float d, float tx, float ty)
+    : a(a), b(b), c(c), d(d), tx(tx), ty(ty) {}
+
+  static constexpr Affine2D translation(float x, float y) { return Affine2D(1, 0, 0, 1, x, y); }
+
+  // Rotation from a precomputed cosine/sine, then translation
+  static constexpr Affine2D rotationTranslation(float cosA, float sinA, float x, float y)
+  {
+    return Affine2D(cosA, sinA, -sinA, cosA, x, y);
+  }
+
+  static Affine2D rotation(float angle)
+  {
+    float sinA, cosA;
+    FastMath::sinCos(angle, sinA, cosA);
+    return rotationTranslation(cosA, sinA, 0.0f, 0.0f);
+  }
+
+  constexpr Mat4 toMat4() const
+  {
+    Mat4 result;
+    result.m[0] = a;
+    result.m[1] = b;
+    result.m[4] = c;
+    result.m[5] = d;
+    result.m[12] = tx;
+    result.m[13] = ty;
+    return result;
+  }
+
+  constexpr void transformPoint(float x, float y, float& outX, float& outY) const
+  {
+    outX = a * x + c * y + tx;
+    outY = b * x + d * y + ty;
+  }
+};
+
+inline Mat4 Mat4::rotationZ(float angle)
+{
+  return Affine2D::rotation(angle).toMat4();
+}
+
+// Batch helpers for instance data
+
+// Transform count packed (x, y) points; in and out may alias
+void transformPoints(const Affine2D& transform, const float* xy, float* out, size_t count);
+
+// One matrix per instance: base * translation(x, y), from count packed (x, y) positions
+void buildTranslationInstances(const Mat4& base, const float* xy, Mat4* out, size_t count);
+
+// Per-instance data of a textured quad, as the instanced sprite shader reads it: the model
+// matrix (for a unit quad with corners at +-1) and the frame's UVs in quad vertex order
+struct alignas(16) SpriteInstance {
+  Mat4 transform;
+  float uv[8];
+};
+
+// One sprite instance per quad: base * translation(x, y) * scale(size) with the UVs of
+// frameTable[frame], from count packed (x, y) positions, sizes and frame indices
+void buildSpriteInstances(const Mat4& base, const float* xy, const float* sizes, const int* frames,
+  const FrameUV* frameTable, SpriteInstance* out, size_t count);